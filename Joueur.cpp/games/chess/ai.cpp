@@ -31,43 +31,40 @@ namespace chess
     // Global state variable that persists between turns and represents a player's internal representation of the game
     State s;
 
-    ////////////////////// History table type definition ///////////////////////
-    struct key_hash
-    {
-        std::size_t operator()(const MyMove& k) const
-        {
-            size_t hashValue;
+    // Transposition table shared by every search thread, kept between turns
+    TranspositionTable transpositionTable;
 
-            /*std::cout << std::get<0>(s.getGlobalLocation(std::get<0>(k))) + s.convertFile(std::get<1>(s.getGlobalLocation(std::get<0>(k)))) << std::endl;
-            std::cout << std::get<0>(std::get<1>(k)) + s.convertFile(std::get<1>(std::get<1>(k))) << std::endl;*/
+    // Static evaluations shared by every search thread, kept between turns
+    EvalCache evalCache;
 
-            // Hash is: (id of piece + 1) ^ (initial rank + initial file) ^ (final rank + final file)
-            hashValue = (std::get<0>(k).id + 1) ^ (std::get<0>(s.getGlobalLocation(std::get<0>(k))) + s.convertFile(std::get<1>(s.getGlobalLocation(std::get<0>(k))))) ^ (std::get<0>(std::get<1>(k)) + s.convertFile(std::get<1>(std::get<1>(k))));
+    // One entry per search thread, the first being the main thread
+    std::vector<std::unique_ptr<SearchThread>> searchThreads;
 
-            return hashValue;
-        }
-    };
-    struct key_equal
-    {
-        bool operator()(const MyMove& lhs, const MyMove& rhs) const
-        {
-            if (std::get<0>(lhs) == std::get<0>(rhs))
-            {
-                if (std::get<0>(std::get<1>(lhs)) == std::get<0>(std::get<1>(rhs)) && std::get<1>(std::get<1>(lhs)) == std::get<1>(std::get<1>(rhs)))
-                    return true;
-            }
+    // Raised once the main thread is done so helper threads abandon their iteration
+    std::atomic<bool> stopSearch(false);
 
-            return false;
-        }
-    };
-    ////////////////////////////////////////////////////////////////////////////
+    // Lazy SMP depth staggering: helper i skips an iteration when ((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) is odd
+    const int SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    const int SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+    // Per-move wall-clock budgets derived from the player's remaining time
+    TimeManager timeManager;
+
+    // Background search on the expected reply while the opponent thinks
+    std::thread ponderThread;
+    State ponderState;
+    uint16_t ponderMove = 0;
 
-    // History Table
-    std::unordered_map<MyMove, int, key_hash, key_equal> historyTable;
+    // Set by the seed setting: every move is searched from the same hash table, move order and thread count,
+    // so the node count for a position and depth doesn't change from run to run
+    bool deterministic = false;
+    unsigned int searchSeed = 0;
 
-    // Global time variables
-    float TIME_LIMIT = 15.0;
-    clock_t t;
+    // Depth the last search of one of our moves completed, which a ponder search has to match to be played at once
+    int lastSearchDepth = 0;
+
+    // Pruning, reduction and extension switches and margins
+    SearchParams searchParams;
 
 /// <summary>
 /// This returns your AI's name to the game server.
@@ -89,11 +86,68 @@ void AI::start()
 {
     // <<-- Creer-Merge: start -->> - Code you add between this comment and the end comment will be preserved between Creer re-runs.
 
+    // Replace the built-in evaluation weights with tuned ones before the first state sums them up
+    std::string evalFile = get_setting("eval_file");
+    if (!evalFile.empty())
+    {
+        if (evalParams.load(evalFile))
+            std::cout << "Loaded evaluation weights from " << evalFile << std::endl;
+        else
+            std::cout << "Could not load evaluation weights from " << evalFile << ", using the defaults" << std::endl;
+    }
+
     // Initialize each board state by parsing FEN notation
     initState();
 
-    // Initialize seed
-    srand(time(NULL));
+    // Evaluate with a network instead of the hand-written terms when given a weights file
+    std::string nnueString = get_setting("nnue");
+    if (!nnueString.empty())
+    {
+        if (network.load(nnueString))
+        {
+            s.refreshAccumulator();
+            std::cout << "Evaluating with network " << nnueString << " (" << nnueKernels() << " kernels)" << std::endl;
+        }
+        else
+            std::cout << "Could not load network " << nnueString << ", using the hand-written evaluation" << std::endl;
+    }
+
+    // A fixed seed makes searches reproducible; otherwise seed from the clock
+    std::string seedString = get_setting("seed");
+    deterministic = !seedString.empty();
+    if (deterministic)
+        searchSeed = stoul(seedString);
+    else
+        searchSeed = time(NULL);
+    srand(searchSeed);
+
+    // Allocate the shared transposition table and one search thread per requested core
+    std::string hashString = get_setting("hash");
+    int evalCacheSize = getIntSetting("eval_cache", DEFAULT_EVAL_CACHE_SIZE);
+    std::string threadString = get_setting("threads");
+    int hashSize = DEFAULT_HASH_SIZE;
+    int threads = 1;
+
+    if (!hashString.empty())
+        hashSize = stoi(hashString);
+    if (!threadString.empty())
+        threads = std::max(1, stoi(threadString));
+
+    // Helper threads race each other through the shared hash table, so a reproducible search uses only the main thread
+    if (deterministic)
+        threads = 1;
+
+    transpositionTable.resize(hashSize);
+    evalCache.resize(evalCacheSize);
+    for (int i = 0; i < threads; i++)
+        searchThreads.push_back(std::unique_ptr<SearchThread>(new SearchThread(i, rand())));
+
+    std::cout << "Searching with " << threads << " thread(s), a " << hashSize << " MB hash table and a " << evalCacheSize << " MB evaluation cache" << std::endl;
+
+    if (deterministic)
+        std::cout << "Deterministic search with seed " << searchSeed << std::endl;
+
+    loadSearchParams();
 
     // <<-- /Creer-Merge: start -->>
 }
@@ -104,6 +158,13 @@ void AI::start()
 void AI::game_updated()
 {
     // <<-- Creer-Merge: game-updated -->> - Code you add between this comment and the end comment will be preserved between Creer re-runs.
+    // Free the cores as soon as the opponent plays something other than the reply we are pondering on
+    if (ponderThread.joinable() && game->current_player == player && !game->moves.empty())
+    {
+        Move lastMove = game->moves.back();
+        if (s.packMove(lastMove->from_rank, lastMove->from_file, std::make_tuple(lastMove->to_rank, lastMove->to_file, lastMove->promotion)) != ponderMove)
+            stopPondering();
+    }
     // <<-- /Creer-Merge: game-updated -->>
 }
 
@@ -115,6 +176,7 @@ void AI::game_updated()
 void AI::ended(bool won, const std::string& reason)
 {
     //<<-- Creer-Merge: ended -->> - Code you add between this comment and the end comment will be preserved between Creer re-runs.
+    stopPondering();
     //<<-- /Creer-Merge: ended -->>
 }
 
@@ -127,20 +189,33 @@ bool AI::run_turn()
     // <<-- Creer-Merge: runTurn -->> - Code you add between this comment and the end comment will be preserved between Creer re-runs.
     // Variables to hold move and depth info
     std::string depthString = get_setting("depth_limit");
+    std::string overheadString = get_setting("move_overhead");
     std::string fromFile, toFile, promotion;
     int depth, fromRank, toRank;
-    int qsDepth = 2;
-    t = clock();
+    double overhead = DEFAULT_MOVE_OVERHEAD;
+
+    if (!overheadString.empty())
+        overhead = stod(overheadString);
+
+    // Start the clock and split the remaining time into a soft and hard budget for this move
+    timeManager.startTurn(player->time_remaining, game->current_turn, game->max_turns, overhead);
 
     if (!depthString.empty())
         depth = stoi(depthString);
     else
-        depth = 3;
+        depth = MAX_DEPTH;
 
     // Update the state of the chess board after opponent's turn
+    bool ponderHit = false;
+    bool searched = true;
     if (!game->moves.empty())
     {
         Move lastMove = game->moves.back();
+
+        // Check the opponent's move against the reply we have been pondering on
+        if (ponderThread.joinable())
+            ponderHit = (s.packMove(lastMove->from_rank, lastMove->from_file, std::make_tuple(lastMove->to_rank, lastMove->to_file, lastMove->promotion)) == ponderMove);
+
         s.updateState(lastMove->from_rank, lastMove->from_file, lastMove->to_rank, lastMove->to_file, lastMove->promotion);
     }
 
@@ -150,36 +225,45 @@ bool AI::run_turn()
     // Display the board state before making move
     std::cout << "Original State: " << std::endl << s << std::endl;
 
-    // History Table Time-Limited Quiesence Search IDDLMM with Alpha-Beta Pruning
-    historyTable.clear();
-    try
+    // Think longer if losing: behind on material, not just on the piece-square tables
+    char opponentColor = (s.getPlayerColor() == 'w') ? 'b' : 'w';
+    if (s.getMaterial(s.getPlayerColor()) < s.getMaterial(opponentColor))
+        timeManager.extendSoft(1.5);
+
+    std::cout << "Time budget: soft " << timeManager.getSoftLimit() << "s, hard " << timeManager.getHardLimit() << "s" << std::endl;
+
+    if (ponderHit)
     {
-        // Search at deeper depth if losing.
-        if (s.stateHeuristic(s.getPlayerColor()) < 0)
+        // The ponder search is already on this position: put it on the real clock and wait for it,
+        // unless it has already searched as deep as our last move was
+        timeManager.setPondering(false);
+        if (searchThreads.at(0)->completedDepth > 0 && searchThreads.at(0)->completedDepth >= std::min(depth, lastSearchDepth))
         {
-            depth = 4;
-            TIME_LIMIT = 35.0;
+            std::cout << "Instant move: ponder search already at depth " << searchThreads.at(0)->completedDepth << std::endl;
+            stopSearch = true;
         }
         else
+            std::cout << "Ponder hit, continuing ponder search" << std::endl;
+        ponderThread.join();
+    }
+    else
+    {
+        // Abandon a ponder search on the wrong reply; what it stored in the hash table is kept
+        stopPondering();
+        searched = !instantMove(depth);
+        if (searched)
         {
-            depth = 3;
-            TIME_LIMIT = 15.0;
+            stopSearch = false;
+            think(s, depth);
         }
+    }
 
-        for (int i = 1; i <= depth; i++)
-        {
-            bestMove = AlphaBetaSearch(s, i, qsDepth);
+    SearchThread* best = bestThread();
+    bestMove = best->bestMove;
+    if (searched)
+        lastSearchDepth = best->completedDepth;
 
-            /*std::cout << "History Table (after " << i << " iteration(s)): " << std::endl;
-            for (std::unordered_map<MyMove, int, key_hash, key_equal>::iterator it = historyTable.begin(); it != historyTable.end(); ++it)
-                std::cout << std::get<0>(it->first) << " to " << std::get<1>(std::get<1>(it->first)) << std::get<0>(std::get<1>(it->first)) << " with value " << it->second << std::endl;
-            std::cout << std::endl;*/
-        }
-    }
-    catch (int i)
-    {
-        std::cout << "Time limit up! Using search result with depth: " << i << std::endl;
-    }
+    std::cout << "Time used: " << timeManager.elapsed() << "s" << std::endl;
 
     // Get the specifics of the move specified by bestMove
     fromRank = std::get<0>(s.getLocation(std::get<0>(bestMove)));
@@ -215,6 +299,10 @@ bool AI::run_turn()
     }
     p->move(toFile, toRank, promotion);
 
+    // Keep searching on the expected reply while the opponent thinks
+    if (get_setting("ponder") == "1" && !deterministic)
+        startPondering(depth);
+
     // <<-- /Creer-Merge: runTurn -->>
 
     return true;
@@ -222,341 +310,1163 @@ bool AI::run_turn()
 
 //<<-- Creer-Merge: methods -->> - Code you add between this comment and the end comment will be preserved between Creer re-runs.
 
-MyMove AI::AlphaBetaSearch(const State& parent, const int& depth, const int& qsDepth)
+// A move that captures or promotes, and so is neither pruned nor reduced
+static bool isTactical(const State& parent, const std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>& child)
+{
+    const std::tuple<int, std::string, std::string>& action = std::get<2>(child);
+
+    // En passant lands on an empty square
+    return !parent.isEmpty(std::get<0>(action), std::get<1>(action)) || parent.isPromotion(std::get<2>(action)) || std::get<2>(action) == "EN PASSANT";
+}
+
+// Plies to extend a move by: checks, and passed pawns pushed to the seventh rank.
+// Nothing is extended past twice the iteration depth so lines can't grow without bound.
+static int searchExtension(const std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>& child, const bool& givesCheck, const int& ply, const int& orgDepth)
+{
+    if (ply >= 2 * orgDepth)
+        return 0;
+
+    if (givesCheck)
+        return searchParams.checkExtension;
+
+    const PieceInfo& piece = std::get<1>(child);
+    const std::tuple<int, std::string, std::string>& action = std::get<2>(child);
+    if ((piece.letter == 'P' && std::get<0>(action) == 7) || (piece.letter == 'p' && std::get<0>(action) == 2))
+    {
+        if (std::get<0>(child).isPassedPawn(std::get<0>(action), std::get<1>(action)))
+            return searchParams.pawnExtension;
+    }
+
+    return 0;
+}
+
+// Plies to reduce a late quiet move by, looked up by depth and move number
+static int lateMoveReduction(const int& depth, const unsigned int& moveNumber, const bool& quiet, const bool& inCheck)
+{
+    if (!searchParams.lmr || !quiet || inCheck || depth < LMR_MIN_DEPTH || moveNumber < LMR_MIN_MOVE)
+        return 0;
+
+    return searchParams.reductions[std::min(depth, LMR_TABLE_SIZE - 1)][std::min((int)moveNumber, LMR_TABLE_SIZE - 1)];
+}
+
+// Reads an integer setting passed through --aiSettings, falling back to defaultValue when it is absent
+int AI::getIntSetting(const std::string& name, const int& defaultValue)
+{
+    std::string value = get_setting(name);
+
+    if (value.empty())
+        return defaultValue;
+
+    return stoi(value);
+}
+
+// Fills in the pruning, reduction and extension parameters from the settings
+void AI::loadSearchParams()
+{
+    searchParams.nullMove = getIntSetting("null_move", 1) != 0;
+    searchParams.nullMoveReduction = getIntSetting("null_move_reduction", DEFAULT_NULL_MOVE_REDUCTION);
+    searchParams.nullMoveVerify = getIntSetting("null_move_verify", DEFAULT_NULL_MOVE_VERIFY);
+
+    searchParams.rfp = getIntSetting("rfp", 1) != 0;
+    searchParams.rfpMargin = getIntSetting("rfp_margin", DEFAULT_RFP_MARGIN);
+    searchParams.rfpDepth = getIntSetting("rfp_depth", DEFAULT_RFP_DEPTH);
+
+    searchParams.futility = getIntSetting("futility", 1) != 0;
+    searchParams.futilityMargin = getIntSetting("futility_margin", DEFAULT_FUTILITY_MARGIN);
+    searchParams.futilityDepth = getIntSetting("futility_depth", DEFAULT_FUTILITY_DEPTH);
+
+    searchParams.razoring = getIntSetting("razoring", 1) != 0;
+    searchParams.razorMargin = getIntSetting("razor_margin", DEFAULT_RAZOR_MARGIN);
+    searchParams.razorDepth = getIntSetting("razor_depth", DEFAULT_RAZOR_DEPTH);
+
+    searchParams.lmr = getIntSetting("lmr", 1) != 0;
+    searchParams.lmrBase = getIntSetting("lmr_base", DEFAULT_LMR_BASE);
+    searchParams.lmrDivisor = std::max(1, getIntSetting("lmr_div", DEFAULT_LMR_DIVISOR));
+    searchParams.initReductions();
+
+    searchParams.checkExtension = getIntSetting("check_ext", DEFAULT_CHECK_EXTENSION);
+    searchParams.pawnExtension = getIntSetting("pawn_ext", DEFAULT_PAWN_EXTENSION);
+
+    searchParams.aspirationWindow = getIntSetting("aspiration_window", DEFAULT_ASPIRATION_WINDOW);
+    searchParams.multiPv = std::max(1, getIntSetting("multipv", DEFAULT_MULTI_PV));
+
+    searchParams.qsMaxPly = getIntSetting("qs_ply", DEFAULT_QS_MAX_PLY);
+    searchParams.deltaMargin = getIntSetting("delta_margin", DEFAULT_DELTA_MARGIN);
+    searchParams.lazyMargin = getIntSetting("lazy_margin", DEFAULT_LAZY_MARGIN);
+
+    std::cout << "Pruning: null move " << searchParams.nullMove << ", reverse futility " << searchParams.rfp << ", futility " << searchParams.futility << ", razoring " << searchParams.razoring << std::endl;
+    std::cout << "Late move reductions " << searchParams.lmr << ", check extension " << searchParams.checkExtension << ", pawn extension " << searchParams.pawnExtension << std::endl;
+    std::cout << "Aspiration window " << searchParams.aspirationWindow << ", multi-PV " << searchParams.multiPv << ", quiescence plies " << searchParams.qsMaxPly << ", delta margin " << searchParams.deltaMargin << ", lazy margin " << searchParams.lazyMargin << std::endl;
+
+    return;
+}
+
+// Answers without searching when the move is obvious: the only legal move, or an exact hash entry that is deep enough.
+// The move goes into the main thread's result for bestThread to pick up.
+bool AI::instantMove(const int& depth)
+{
+    StateActionPair childStates = s.generateChildren();
+    SearchThread& thread = *searchThreads.at(0);
+
+    TTData entry;
+    bool hashHit = transpositionTable.probe(s.getHashKey(), entry);
+
+    for (unsigned int i = 0; i < searchThreads.size(); i++)
+        searchThreads.at(i)->clear();
+
+    if (childStates.size() == 1)
+    {
+        std::cout << "Instant move: only legal move" << std::endl;
+        thread.bestMove = std::make_tuple(std::get<1>(childStates.at(0)), std::get<2>(childStates.at(0)));
+        thread.bestScore = (hashHit && entry.bound == TT_EXACT) ? entry.score : 0;
+        return true;
+    }
+
+    // A deterministic search must not depend on what earlier moves left in the table
+    if (deterministic || !hashHit || entry.bound != TT_EXACT || entry.move == 0 || entry.depth < std::min(depth, INSTANT_HASH_DEPTH))
+        return false;
+
+    for (unsigned int i = 0; i < childStates.size(); i++)
+    {
+        std::tuple<int, std::string> from = s.findLocation(std::get<1>(childStates.at(i)));
+
+        if (s.packMove(std::get<0>(from), std::get<1>(from), std::get<2>(childStates.at(i))) == entry.move)
+        {
+            std::cout << "Instant move: hash entry at depth " << entry.depth << std::endl;
+            thread.bestMove = std::make_tuple(std::get<1>(childStates.at(i)), std::get<2>(childStates.at(i)));
+            thread.bestScore = entry.score;
+            thread.bestPv.assign(1, entry.move);
+            thread.completedDepth = entry.depth;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Lazy SMP History Table Time-Limited Quiesence Search IDDLMM with Alpha-Beta Pruning.
+// Every thread runs its own iterative deepening on the same root, sharing only the transposition table.
+// The caller clears stopSearch before starting it.
+void AI::think(const State& root, const int& depth)
+{
+    // What earlier moves left in the tables would change this search's tree
+    if (deterministic)
+    {
+        transpositionTable.clear();
+        evalCache.clear();
+    }
+
+    transpositionTable.newSearch();
+    timeManager.startSearch();
+    for (unsigned int i = 0; i < searchThreads.size(); i++)
+    {
+        searchThreads.at(i)->clear();
+        if (deterministic)
+            searchThreads.at(i)->rng.seed(searchSeed + i);
+    }
+
+    std::vector<std::thread> helpers;
+    for (unsigned int i = 1; i < searchThreads.size(); i++)
+        helpers.push_back(std::thread(&AI::searchWorker, this, std::ref(*searchThreads.at(i)), std::cref(root), depth));
+
+    searchWorker(*searchThreads.at(0), root, depth);
+
+    stopSearch = true;
+    for (unsigned int i = 0; i < helpers.size(); i++)
+        helpers.at(i).join();
+
+    // Stable for a given position and depth, so a change in it means the search itself changed
+    if (deterministic)
+        std::cout << "Signature: depth " << searchThreads.at(0)->completedDepth << ", " << searchThreads.at(0)->nodes << " nodes" << std::endl;
+
+    return;
+}
+
+// The thread with the deepest completed iteration, preferring the main thread on ties
+SearchThread* AI::bestThread()
+{
+    SearchThread* best = searchThreads.at(0).get();
+    uint64_t nodes = 0, nullCutoffs = 0, rfpCutoffs = 0, razorCutoffs = 0, futilityPrunes = 0, reductions = 0, researches = 0, extensions = 0, aspirationResearches = 0;
+    uint64_t qsNodes = 0, seePrunes = 0, deltaPrunes = 0, evalProbes = 0, evalHits = 0, pawnProbes = 0, pawnHits = 0;
+    uint64_t materialProbes = 0, materialHits = 0;
+    uint64_t lazyExits = 0, lazyChecks = 0, lazyErrors = 0;
+
+    for (unsigned int i = 0; i < searchThreads.size(); i++)
+    {
+        nodes += searchThreads.at(i)->nodes;
+        nullCutoffs += searchThreads.at(i)->nullCutoffs;
+        rfpCutoffs += searchThreads.at(i)->rfpCutoffs;
+        razorCutoffs += searchThreads.at(i)->razorCutoffs;
+        futilityPrunes += searchThreads.at(i)->futilityPrunes;
+        reductions += searchThreads.at(i)->reductions;
+        researches += searchThreads.at(i)->researches;
+        extensions += searchThreads.at(i)->extensions;
+        aspirationResearches += searchThreads.at(i)->aspirationResearches;
+        qsNodes += searchThreads.at(i)->qsNodes;
+        seePrunes += searchThreads.at(i)->seePrunes;
+        deltaPrunes += searchThreads.at(i)->deltaPrunes;
+        evalProbes += searchThreads.at(i)->evalProbes;
+        evalHits += searchThreads.at(i)->evalHits;
+        lazyExits += searchThreads.at(i)->lazyExits;
+        lazyChecks += searchThreads.at(i)->lazyChecks;
+        lazyErrors += searchThreads.at(i)->lazyErrors;
+        pawnProbes += searchThreads.at(i)->pawnTable.probes;
+        pawnHits += searchThreads.at(i)->pawnTable.hits;
+        materialProbes += searchThreads.at(i)->materialTable.probes;
+        materialHits += searchThreads.at(i)->materialTable.hits;
+
+        if (searchThreads.at(i)->completedDepth > best->completedDepth)
+            best = searchThreads.at(i).get();
+    }
+
+    std::cout << "Using depth " << best->completedDepth << " result of thread " << best->id << ", score " << scoreString(best->bestScore) << " (" << nodes << " nodes)" << std::endl;
+    std::cout << "Pruned: " << nullCutoffs << " null move, " << rfpCutoffs << " reverse futility, " << razorCutoffs << " razoring, " << futilityPrunes << " futility" << std::endl;
+    std::cout << "Reduced: " << reductions << " moves, " << researches << " re-searched; extended: " << extensions << " moves" << std::endl;
+    std::cout << "Aspiration re-searches: " << aspirationResearches << std::endl;
+    std::cout << "Quiescence: " << qsNodes << " nodes, " << seePrunes << " losing captures, " << deltaPrunes << " delta pruned" << std::endl;
+    std::cout << "Evaluation cache: " << evalHits << " hits in " << evalProbes << " probes" << std::endl;
+    std::cout << "Lazy evaluation: " << lazyExits << " early exits, " << lazyErrors << " of " << lazyChecks << " checked were wrong" << std::endl;
+    std::cout << "Pawn table: " << pawnHits << " hits in " << pawnProbes << " probes" << std::endl;
+    std::cout << "Material table: " << materialHits << " hits in " << materialProbes << " probes" << std::endl;
+
+    return best;
+}
+
+// One line per completed iteration (and per line in multi-PV mode): depth, selective depth, score, nodes of all threads,
+// speed, hash usage, time and PV
+void AI::printInfo(const SearchThread& thread, const State& root, const int& line, const int& score, const std::vector<uint16_t>& pv)
+{
+    uint64_t nodes = 0;
+    for (unsigned int i = 0; i < searchThreads.size(); i++)
+        nodes += searchThreads.at(i)->nodes;
+
+    double elapsed = timeManager.elapsed();
+
+    std::cout << "info depth " << thread.completedDepth << " seldepth " << thread.selDepth;
+    if (searchParams.multiPv > 1)
+        std::cout << " multipv " << line;
+    std::cout << " score " << scoreString(score) << " nodes " << nodes << " nps " << (uint64_t)(nodes / std::max(elapsed, 0.001)) << " hashfull " << transpositionTable.hashfull()
+              << " time " << (int)(elapsed * 1000) << " pv";
+    for (unsigned int i = 0; i < pv.size(); i++)
+        std::cout << " " << root.moveString(pv.at(i));
+    std::cout << std::endl;
+
+    return;
+}
+
+// Starts a background search on the position after the opponent's expected reply, taken from the hash table
+void AI::startPondering(const int& depth)
+{
+    State opponent = s;
+    opponent.switchSides();
+
+    TTData entry;
+    if (!transpositionTable.probe(opponent.getHashKey(), entry) || entry.move == 0)
+        return;
+
+    StateActionPair replies = opponent.generateChildren();
+    for (unsigned int i = 0; i < replies.size(); i++)
+    {
+        std::tuple<int, std::string> from = opponent.findLocation(std::get<1>(replies.at(i)));
+
+        if (opponent.packMove(std::get<0>(from), std::get<1>(from), std::get<2>(replies.at(i))) == entry.move)
+        {
+            ponderState = std::get<0>(replies.at(i));
+            ponderState.switchSides();
+            ponderMove = entry.move;
+
+            std::cout << "Pondering on " << std::get<1>(replies.at(i)) << " to " << std::get<1>(std::get<2>(replies.at(i))) << std::get<0>(std::get<2>(replies.at(i))) << std::endl;
+
+            // Cleared here rather than on the ponder thread, so that a stopPondering() before it starts is not lost
+            timeManager.setPondering(true);
+            stopSearch = false;
+            ponderThread = std::thread(&AI::think, this, std::cref(ponderState), depth);
+            break;
+        }
+    }
+
+    return;
+}
+
+// Stops a running ponder search and waits for its threads
+void AI::stopPondering()
+{
+    if (ponderThread.joinable())
+    {
+        stopSearch = true;
+        timeManager.setPondering(false);
+        ponderThread.join();
+    }
+
+    return;
+}
+
+// Iterative deepening run by every search thread. Helpers stagger their depths and stop once the main thread is done.
+void AI::searchWorker(SearchThread& thread, const State& root, const int& depth)
+{
+    try
+    {
+        for (int i = 1; i <= depth && !stopSearch; i++)
+        {
+            // The main thread only starts an iteration it expects to finish within the soft budget. Giving up early
+            // leaves the time on the clock, where the budgets of later moves pick it up.
+            if (thread.id == 0 && i > 1 && !timeManager.iterationFits())
+            {
+                std::cout << "Not starting depth " << i << ": predicted " << timeManager.predictIteration() << "s with "
+                          << std::max(0.0, timeManager.getSoftLimit() - timeManager.elapsed()) << "s of the soft budget left" << std::endl;
+                break;
+            }
+
+            if (thread.id == 0)
+                timeManager.startIteration();
+
+            if (thread.id > 0)
+            {
+                int k = (thread.id - 1) % 20;
+                if (((i + SKIP_PHASE[k]) / SKIP_SIZE[k]) % 2)
+                    continue;
+            }
+
+            thread.selDepth = 0;
+
+            // Search inside a window around the last iteration's score, widening whichever side fails
+            int delta = searchParams.aspirationWindow;
+            int alpha = -INFINITE_SCORE;
+            int beta = INFINITE_SCORE;
+            if (delta > 0 && i >= ASPIRATION_MIN_DEPTH && !isMateScore(thread.bestScore))
+            {
+                alpha = thread.bestScore - delta;
+                beta = thread.bestScore + delta;
+            }
+
+            std::tuple<int, MyMove> result = AlphaBetaSearch(root, i, alpha, beta, thread, std::vector<uint16_t>());
+            while ((alpha != -INFINITE_SCORE && std::get<0>(result) < alpha) || (beta != INFINITE_SCORE && std::get<0>(result) > beta))
+            {
+                thread.aspirationResearches++;
+                delta *= 2;
+
+                if (std::get<0>(result) < alpha)
+                    alpha = (delta > ASPIRATION_MAX_WINDOW || isMateScore(std::get<0>(result))) ? -INFINITE_SCORE : std::get<0>(result) - delta;
+                else
+                    beta = (delta > ASPIRATION_MAX_WINDOW || isMateScore(std::get<0>(result))) ? INFINITE_SCORE : std::get<0>(result) + delta;
+
+                result = AlphaBetaSearch(root, i, alpha, beta, thread, std::vector<uint16_t>());
+            }
+
+            // A mate for us found by two iterations in a row won't be improved by searching deeper
+            bool mateConfirmed = (std::get<0>(result) >= MATE_BOUND && std::get<0>(result) == thread.bestScore && searchParams.multiPv == 1);
+
+            thread.bestScore = std::get<0>(result);
+            thread.bestMove = std::get<1>(result);
+            thread.bestPv.assign(thread.pv[0], thread.pv[0] + thread.pvLength[0]);
+            thread.completedDepth = i;
+
+            if (thread.id == 0)
+                printInfo(thread, root, 1, thread.bestScore, thread.bestPv);
+
+            // Multi-PV: the next best lines are searched with full windows and the moves already reported excluded.
+            // They share the hash table with the first line, so most of each tree is already there.
+            if (thread.id == 0 && searchParams.multiPv > 1 && !thread.bestPv.empty())
+            {
+                std::vector<uint16_t> excluded(1, thread.bestPv.at(0));
+
+                for (int line = 2; line <= searchParams.multiPv; line++)
+                {
+                    result = AlphaBetaSearch(root, i, -INFINITE_SCORE, INFINITE_SCORE, thread, excluded);
+
+                    // Every root move has been reported
+                    if (thread.pvLength[0] == 0)
+                        break;
+
+                    excluded.push_back(thread.pv[0][0]);
+                    printInfo(thread, root, line, std::get<0>(result), std::vector<uint16_t>(thread.pv[0], thread.pv[0] + thread.pvLength[0]));
+                }
+            }
+
+            if (thread.id == 0)
+            {
+                timeManager.endIteration();
+
+                if (mateConfirmed)
+                {
+                    std::cout << "Instant move: " << scoreString(thread.bestScore) << " confirmed at depth " << i << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+    catch (int i)
+    {
+        if (thread.id == 0)
+            std::cout << "Time limit up! Using search result with depth: " << i << std::endl;
+    }
+
+    return;
+}
+
+// Root search. Moves in excluded are skipped, and then nothing is stored since the result isn't the position's best move.
+std::tuple<int, MyMove> AI::AlphaBetaSearch(const State& parent, const int& depth, int alpha, int beta, SearchThread& thread, const std::vector<uint16_t>& excluded)
 {
     // Vector containing all child states paired with the move that results in that state
     StateActionPair childStates = parent.generateChildren();
-    std::random_shuffle(childStates.begin(), childStates.end());
+    std::shuffle(childStates.begin(), childStates.end(), thread.rng);
 
-    // Establish initial alpha-beta values
-    int alpha = INT_MIN;
-    int beta = INT_MAX;
+    // Try the move stored by an earlier iteration (or another thread) first
+    uint64_t key = parent.getHashKey();
+    TTData entry;
+    uint16_t ttMove = 0;
+    if (transpositionTable.probe(key, entry))
+        ttMove = entry.move;
+    std::vector<uint16_t> moves = orderChildren(parent, childStates, ttMove, 0, thread);
+
+    int alphaOrig = alpha;
 
     // Tuple containing the max utility value paired with the associated move
     std::tuple<int, MyMove> currentMax;
-    std::get<0>(currentMax) = INT_MIN;
+    std::get<0>(currentMax) = -INFINITE_SCORE;
+    uint16_t bestMove = 0;
+    thread.clearPv(0);
 
     // Generate utility values for all child states and keep track of highest utility value
     for (unsigned int i = 0; i < childStates.size(); i++)
     {
-        int value = MinValue(std::get<0>(childStates.at(i)), depth - 1, qsDepth, depth, alpha, beta);
+        if (std::find(excluded.begin(), excluded.end(), moves.at(i)) != excluded.end())
+            continue;
+
+        int value = MinValue(std::get<0>(childStates.at(i)), depth - 1, depth, alpha, beta, 1, thread);
 
         if (value >= std::get<0>(currentMax))
+        {
             currentMax = std::make_tuple(value, std::make_tuple(std::get<1>(childStates.at(i)), std::get<2>(childStates.at(i))));
+            bestMove = moves.at(i);
+            thread.updatePv(0, bestMove);
+        }
+
+        // Fail high out of an aspiration window
+        if (value > beta)
+            break;
 
         alpha = std::max(alpha, value);
     }
 
+    if (!excluded.empty())
+        return currentMax;
+
     // Add to history table
-    if (!historyTable.count(std::get<1>(currentMax)))
-        historyTable[std::get<1>(currentMax)] = 1;
+    if (!thread.historyTable.count(std::get<1>(currentMax)))
+        thread.historyTable[std::get<1>(currentMax)] = 1;
     else
-        historyTable[std::get<1>(currentMax)] = historyTable[std::get<1>(currentMax)] + 1;
+        thread.historyTable[std::get<1>(currentMax)] = thread.historyTable[std::get<1>(currentMax)] + 1;
+
+    transpositionTable.store(key, std::get<0>(currentMax), depth, (std::get<0>(currentMax) > beta) ? TT_LOWER : ((std::get<0>(currentMax) < alphaOrig) ? TT_UPPER : TT_EXACT), bestMove);
 
-    return std::get<1>(currentMax);
+    return currentMax;
 }
 
-int AI::MinValue(State parent, const int& depth, const int& qsDepth, const int& orgDepth, int alpha, int beta)
+int AI::MinValue(State parent, const int& depth, const int& orgDepth, int alpha, int beta, const int& ply, SearchThread& thread)
 {
-    // Make sure time does not exceed the set time limit
-    clock_t test = clock() - t;
-    if (((float)test)/CLOCKS_PER_SEC >= TIME_LIMIT && orgDepth != 1)
+    // Depth limit reached: play out captures before evaluating
+    if (depth <= 0)
+        return QMinValue(parent, orgDepth, alpha, beta, ply, 0, thread);
+
+    thread.clearPv(ply);
+
+    // Make sure time does not exceed the hard budget for this move, and stop helpers once the main thread is done
+    if (orgDepth != 1 && (stopSearch || (thread.id == 0 && timeManager.hardExpired())))
         throw (orgDepth - 1);
 
+    thread.nodes++;
+
     // Update state so Min-Player is at play
     parent.switchSides();
 
-    // Terminal state test
+    // Draw by repetition, insufficient material or the 50 move rule
     if (parent.isDraw())
         return 0;
-    else if (parent.isWin(s.getPlayerColor()))
-        return INT_MAX;
-    else if (parent.isLoss(s.getPlayerColor()))
-        return INT_MIN;
-
-    // Depth limit reached test with non-quiescent state possibility
-    if (depth == 0 && (parent.isQuiet() || qsDepth == 0))
-        return parent.stateHeuristic(s.getPlayerColor());
-    else
+
+    // Mate distance pruning: Min can do no worse than being mated right here and no better than mating next move
+    if (MATE - ply < alpha)
+        return MATE - ply;
+    if (-MATE + ply + 1 > beta)
+        return -MATE + ply + 1;
+
+    // Probe the shared transposition table for a cutoff or a move to try first
+    uint64_t key = parent.getHashKey();
+    TTData entry;
+    uint16_t ttMove = 0;
+    int betaOrig = beta;
+    if (transpositionTable.probe(key, entry))
     {
-        StateActionPair childStates = parent.generateChildren();
-        std::random_shuffle(childStates.begin(), childStates.end());
+        ttMove = entry.move;
+        entry.score = scoreFromTT(entry.score, ply);
+
+        if (entry.depth >= depth && (entry.bound == TT_EXACT || (entry.bound == TT_LOWER && entry.score >= beta) || (entry.bound == TT_UPPER && entry.score <= alpha)))
+            return entry.score;
+    }
 
-        // Variable containing the highest utility value thus far
-        int value = INT_MAX;
-        int minIndex = 0;
-        MyMove move;
+    // Forward pruning, never while in check and only against a bound that is not a mate score
+    bool inCheck = parent.kingInCheck();
+    int staticEval = 0;
+    bool futile = false;
+    int futilityValue = 0;
+    if (!inCheck)
+    {
+        staticEval = evaluate(parent, thread, -INFINITE_SCORE, INFINITE_SCORE);
 
-        for (unsigned int i = 0; i < childStates.size(); i++)
+        // Reverse futility: so far below alpha that no move is expected to bring it back up
+        if (searchParams.rfp && depth <= searchParams.rfpDepth && !isMateScore(alpha) && staticEval + searchParams.rfpMargin * depth < alpha)
         {
-            int maxValue;
+            thread.rfpCutoffs++;
+            return staticEval;
+        }
 
-            // Different calls depending on whether depth limit has been reached.
-            if (depth == 0)
-                maxValue = MaxValue(std::get<0>(childStates.at(i)), depth, qsDepth - 1, orgDepth, alpha, beta);
-            else
-                maxValue = MaxValue(std::get<0>(childStates.at(i)), depth - 1, qsDepth, orgDepth, alpha, beta);
+        // Razoring: hopelessly above beta, so trust a quiescent search instead of a full one
+        if (searchParams.razoring && depth <= searchParams.razorDepth && !isMateScore(beta) && staticEval - searchParams.razorMargin * depth > beta)
+        {
+            State razor = parent;
+            razor.switchSides();
 
-            // Get the minimum of value and maxValue. Keep track of the index.
-            if (value > maxValue)
+            int razorValue = QMinValue(razor, orgDepth, alpha, beta, ply, 0, thread);
+            if (razorValue > beta)
             {
-                value = maxValue;
-                minIndex = i;
+                thread.razorCutoffs++;
+                return razorValue;
             }
+        }
 
-            // Pruning possibility
-            if (value < alpha)
+        // Null move: if passing still leaves Max below alpha, a real move will too
+        if (searchParams.nullMove && depth >= 2 && !isMateScore(alpha) && staticEval < alpha && ply < MAX_PLY && ply >= thread.nullMoveMinPly && (ply == 0 || !thread.nullMove[ply - 1]) && parent.nonPawnMaterial() > 0)
+        {
+            int nullDepth = std::max(0, depth - 1 - searchParams.nullMoveReduction - ((depth >= 6) ? 1 : 0));
+            State nullState = parent;
+            nullState.setEnPassant(-1, "NULL");
+
+            thread.nullMove[ply] = true;
+            int nullValue = MaxValue(nullState, nullDepth, orgDepth, alpha - 1, alpha, ply + 1, thread);
+            thread.nullMove[ply] = false;
+
+            if (nullValue < alpha)
             {
-                // Get the move that caused the prune
-                move = std::make_tuple(std::get<1>(childStates.at(i)), std::get<2>(childStates.at(i)));
+                // Zugzwang is likely with little material left, so confirm with a reduced search without null moves
+                if (thread.nullMoveMinPly == 0 && parent.nonPawnMaterial() <= searchParams.nullMoveVerify)
+                {
+                    State verify = parent;
+                    verify.switchSides();
+
+                    thread.nullMoveMinPly = ply + 1 + 3 * nullDepth / 4;
+                    nullValue = MinValue(verify, nullDepth, orgDepth, alpha - 1, alpha, ply, thread);
+                    thread.nullMoveMinPly = 0;
+                }
+
+                // Don't return an unproven mate
+                if (nullValue < alpha)
+                {
+                    thread.nullCutoffs++;
+                    return isMateScore(nullValue) ? alpha - 1 : nullValue;
+                }
+            }
+        }
 
-                // Add to history table
-                if (!historyTable.count(move))
-                    historyTable[move] = 1;
-                else
-                    historyTable[move] = historyTable[move] + 1;
+        // Futility: at the frontier quiet moves can't bring a hopeless evaluation back under beta
+        futilityValue = staticEval - searchParams.futilityMargin * depth;
+        futile = searchParams.futility && depth <= searchParams.futilityDepth && !isMateScore(beta) && futilityValue >= beta;
+    }
+
+    StateActionPair childStates = parent.generateChildren();
+    std::shuffle(childStates.begin(), childStates.end(), thread.rng);
+    std::vector<uint16_t> moves = orderChildren(parent, childStates, ttMove, ply, thread);
+
+    // No legal move: Min is checkmated or stalemated
+    if (childStates.empty())
+        return inCheck ? MATE - ply : 0;
+
+    // Variable containing the highest utility value thus far
+    int value = INFINITE_SCORE;
+    int minIndex = 0;
+    MyMove move;
+
+    for (unsigned int i = 0; i < childStates.size(); i++)
+    {
+        int maxValue;
+        bool givesCheck = std::get<0>(childStates.at(i)).oppKingInCheck();
+        bool quiet = !givesCheck && !isTactical(parent, childStates.at(i));
+
+        if (futile && i > 0 && quiet)
+        {
+            thread.futilityPrunes++;
+            value = std::min(value, futilityValue);
+            continue;
+        }
+
+        int extension = searchExtension(childStates.at(i), givesCheck, ply, orgDepth);
+        int newDepth = depth - 1 + extension;
+        int reduction = (extension == 0) ? lateMoveReduction(depth, i, quiet, inCheck) : 0;
+
+        if (extension > 0)
+            thread.extensions++;
 
-                return value;
+        if (reduction > 0)
+        {
+            // Search late moves shallower, and again at full depth only if one turns out better than beta
+            thread.reductions++;
+            maxValue = MaxValue(std::get<0>(childStates.at(i)), std::max(1, newDepth - reduction), orgDepth, alpha, beta, ply + 1, thread);
+
+            if (maxValue < beta)
+            {
+                thread.researches++;
+                maxValue = MaxValue(std::get<0>(childStates.at(i)), newDepth, orgDepth, alpha, beta, ply + 1, thread);
             }
+        }
+        else
+            maxValue = MaxValue(std::get<0>(childStates.at(i)), newDepth, orgDepth, alpha, beta, ply + 1, thread);
 
-            beta = std::min(value, beta);
+        // Get the minimum of value and maxValue. Keep track of the index.
+        if (value > maxValue)
+        {
+            value = maxValue;
+            minIndex = i;
+            thread.updatePv(ply, moves.at(i));
         }
 
-        // Get the move that leads to the lowest value
-        if (!childStates.empty())
+        // Pruning possibility
+        if (value < alpha)
         {
-            move = std::make_tuple(std::get<1>(childStates.at(minIndex)), std::get<2>(childStates.at(minIndex)));
+            // Remember quiet moves that caused the prune as killers for this ply
+            const std::tuple<int, std::string, std::string>& action = std::get<2>(childStates.at(i));
+            if (ply < MAX_PLY && parent.isEmpty(std::get<0>(action), std::get<1>(action)) && thread.killers[ply][0] != moves.at(i))
+            {
+                thread.killers[ply][1] = thread.killers[ply][0];
+                thread.killers[ply][0] = moves.at(i);
+            }
 
-            // Add to history table
-            if (!historyTable.count(move))
-                historyTable[move] = 1;
-            else
-                historyTable[move] = historyTable[move] + 1;
+            break;
         }
 
-        return value;
+        beta = std::min(value, beta);
+    }
+
+    // Get the move that leads to the lowest value
+    if (!childStates.empty())
+    {
+        move = std::make_tuple(std::get<1>(childStates.at(minIndex)), std::get<2>(childStates.at(minIndex)));
+
+        // Add to history table
+        if (!thread.historyTable.count(move))
+            thread.historyTable[move] = 1;
+        else
+            thread.historyTable[move] = thread.historyTable[move] + 1;
+
+        transpositionTable.store(key, scoreToTT(value, ply), depth, (value <= alpha) ? TT_UPPER : ((value >= betaOrig) ? TT_LOWER : TT_EXACT), moves.at(minIndex));
     }
+
+    return value;
 }
 
-int AI::MaxValue(State parent, const int& depth, const int& qsDepth, const int& orgDepth, int alpha, int beta)
+int AI::MaxValue(State parent, const int& depth, const int& orgDepth, int alpha, int beta, const int& ply, SearchThread& thread)
 {
-    // Make sure time does not exceed the set time limit
-    clock_t test = clock() - t;
-    if (((float)test)/CLOCKS_PER_SEC >= TIME_LIMIT && orgDepth != 1)
+    // Depth limit reached: play out captures before evaluating
+    if (depth <= 0)
+        return QMaxValue(parent, orgDepth, alpha, beta, ply, 0, thread);
+
+    thread.clearPv(ply);
+
+    // Make sure time does not exceed the hard budget for this move, and stop helpers once the main thread is done
+    if (orgDepth != 1 && (stopSearch || (thread.id == 0 && timeManager.hardExpired())))
         throw (orgDepth - 1);
 
+    thread.nodes++;
+
     // Update state so Max-Player is at play
     parent.switchSides();
 
-    // Terminal state test
+    // Draw by repetition, insufficient material or the 50 move rule
     if (parent.isDraw())
         return 0;
-    else if (parent.isWin(s.getPlayerColor()))
-        return INT_MAX;
-    else if (parent.isLoss(s.getPlayerColor()))
-        return INT_MIN;
-
-    // Depth limit reached test with non-quiescent state possibility
-    if (depth == 0 && (parent.isQuiet() || qsDepth == 0))
-        return parent.stateHeuristic(s.getPlayerColor());
-    else
+
+    // Mate distance pruning: Max can do no worse than being mated right here and no better than mating next move
+    if (-MATE + ply > beta)
+        return -MATE + ply;
+    if (MATE - ply - 1 < alpha)
+        return MATE - ply - 1;
+
+    // Probe the shared transposition table for a cutoff or a move to try first
+    uint64_t key = parent.getHashKey();
+    TTData entry;
+    uint16_t ttMove = 0;
+    int alphaOrig = alpha;
+    if (transpositionTable.probe(key, entry))
     {
-        StateActionPair childStates = parent.generateChildren();
-        std::random_shuffle(childStates.begin(), childStates.end());
+        ttMove = entry.move;
+        entry.score = scoreFromTT(entry.score, ply);
+
+        if (entry.depth >= depth && (entry.bound == TT_EXACT || (entry.bound == TT_LOWER && entry.score >= beta) || (entry.bound == TT_UPPER && entry.score <= alpha)))
+            return entry.score;
+    }
 
-        // Variable containing the highest utility value thus far
-        int value = INT_MIN;
-        int maxIndex = 0;
-        MyMove move;
+    // Forward pruning, never while in check and only against a bound that is not a mate score
+    bool inCheck = parent.kingInCheck();
+    int staticEval = 0;
+    bool futile = false;
+    int futilityValue = 0;
+    if (!inCheck)
+    {
+        staticEval = evaluate(parent, thread, -INFINITE_SCORE, INFINITE_SCORE);
 
-        for (unsigned int i = 0; i < childStates.size(); i++)
+        // Reverse futility: so far above beta that no move is expected to bring it back down
+        if (searchParams.rfp && depth <= searchParams.rfpDepth && !isMateScore(beta) && staticEval - searchParams.rfpMargin * depth > beta)
         {
-            int minValue;
+            thread.rfpCutoffs++;
+            return staticEval;
+        }
 
-            // Different calls depending on whether depth limit has been reached.
-            if (depth == 0)
-                minValue = MinValue(std::get<0>(childStates.at(i)), depth, qsDepth - 1, orgDepth, alpha, beta);
-            else
-                minValue = MinValue(std::get<0>(childStates.at(i)), depth - 1, qsDepth, orgDepth, alpha, beta);
+        // Razoring: hopelessly below alpha, so trust a quiescent search instead of a full one
+        if (searchParams.razoring && depth <= searchParams.razorDepth && !isMateScore(alpha) && staticEval + searchParams.razorMargin * depth < alpha)
+        {
+            State razor = parent;
+            razor.switchSides();
 
-            // Get the maximum of value and minValue. Keep track of the index.
-            if (value < minValue)
+            int razorValue = QMaxValue(razor, orgDepth, alpha, beta, ply, 0, thread);
+            if (razorValue < alpha)
             {
-                value = minValue;
-                maxIndex = i;
+                thread.razorCutoffs++;
+                return razorValue;
             }
+        }
 
-            // Pruning possibility
-            if (value > beta)
-            {
-                // Get the move that caused the prune
-                move = std::make_tuple(std::get<1>(childStates.at(i)), std::get<2>(childStates.at(i)));
+        // Null move: if passing still leaves Min above beta, a real move will too
+        if (searchParams.nullMove && depth >= 2 && !isMateScore(beta) && staticEval > beta && ply < MAX_PLY && ply >= thread.nullMoveMinPly && (ply == 0 || !thread.nullMove[ply - 1]) && parent.nonPawnMaterial() > 0)
+        {
+            int nullDepth = std::max(0, depth - 1 - searchParams.nullMoveReduction - ((depth >= 6) ? 1 : 0));
+            State nullState = parent;
+            nullState.setEnPassant(-1, "NULL");
 
-                // Add to history table
-                if (!historyTable.count(move))
-                    historyTable[move] = 1;
-                else
-                    historyTable[move] = historyTable[move] + 1;
+            thread.nullMove[ply] = true;
+            int nullValue = MinValue(nullState, nullDepth, orgDepth, beta, beta + 1, ply + 1, thread);
+            thread.nullMove[ply] = false;
 
-                return value;
+            if (nullValue > beta)
+            {
+                // Zugzwang is likely with little material left, so confirm with a reduced search without null moves
+                if (thread.nullMoveMinPly == 0 && parent.nonPawnMaterial() <= searchParams.nullMoveVerify)
+                {
+                    State verify = parent;
+                    verify.switchSides();
+
+                    thread.nullMoveMinPly = ply + 1 + 3 * nullDepth / 4;
+                    nullValue = MaxValue(verify, nullDepth, orgDepth, beta, beta + 1, ply, thread);
+                    thread.nullMoveMinPly = 0;
+                }
+
+                // Don't return an unproven mate
+                if (nullValue > beta)
+                {
+                    thread.nullCutoffs++;
+                    return isMateScore(nullValue) ? beta + 1 : nullValue;
+                }
             }
-
-            alpha = std::max(value, alpha);
         }
 
-        // Get the move that leads to the lowest value
-        if (!childStates.empty())
-        {
-            move = std::make_tuple(std::get<1>(childStates.at(maxIndex)), std::get<2>(childStates.at(maxIndex)));
+        // Futility: at the frontier quiet moves can't lift a hopeless evaluation over alpha
+        futilityValue = staticEval + searchParams.futilityMargin * depth;
+        futile = searchParams.futility && depth <= searchParams.futilityDepth && !isMateScore(alpha) && futilityValue <= alpha;
+    }
 
-            // Add to history table
-            if (!historyTable.count(move))
-                historyTable[move] = 1;
-            else
-                historyTable[move] = historyTable[move] + 1;
-        }
+    StateActionPair childStates = parent.generateChildren();
+    std::shuffle(childStates.begin(), childStates.end(), thread.rng);
+    std::vector<uint16_t> moves = orderChildren(parent, childStates, ttMove, ply, thread);
 
-        return value;
-    }
-}
+    // No legal move: Max is checkmated or stalemated
+    if (childStates.empty())
+        return inCheck ? -MATE + ply : 0;
 
-// Parses the FEN string and places pieces in state's 2D array
-void AI::initState()
-{
-    // Set the color for this player
-    s.setPlayerColor(player->color);
-
-    // Variables to parse the FEN string
-    int index = 0, i = 8, j = 0;
-
-    // Info to construct a PieceInfo struct (my version of the framework's Piece)
-    char l = game->fen.at(index);
-    char color;
-    int id = 1;
-
-    // Determine color of piece
-    if (islower(l))
-        color = 'b';
-    else if (isupper(l))
-        color = 'w';
-    else
-        color = '-';
+    // Variable containing the highest utility value thus far
+    int value = -INFINITE_SCORE;
+    int maxIndex = 0;
+    MyMove move;
 
-    // Parse string one character at a time
-    while (l != ' ')
+    for (unsigned int i = 0; i < childStates.size(); i++)
     {
-        if (l > '0' && l < '9')
+        int minValue;
+        bool givesCheck = std::get<0>(childStates.at(i)).oppKingInCheck();
+        bool quiet = !givesCheck && !isTactical(parent, childStates.at(i));
+
+        if (futile && i > 0 && quiet)
         {
-            for (int k = 0; k < (l - '0'); ++k)
+            thread.futilityPrunes++;
+            value = std::max(value, futilityValue);
+            continue;
+        }
+
+        int extension = searchExtension(childStates.at(i), givesCheck, ply, orgDepth);
+        int newDepth = depth - 1 + extension;
+        int reduction = (extension == 0) ? lateMoveReduction(depth, i, quiet, inCheck) : 0;
+
+        if (extension > 0)
+            thread.extensions++;
+
+        if (reduction > 0)
+        {
+            // Search late moves shallower, and again at full depth only if one turns out better than alpha
+            thread.reductions++;
+            minValue = MinValue(std::get<0>(childStates.at(i)), std::max(1, newDepth - reduction), orgDepth, alpha, beta, ply + 1, thread);
+
+            if (minValue > alpha)
             {
-                s.setBoard(color, '-', 0, i, j);
-                j++;
+                thread.researches++;
+                minValue = MinValue(std::get<0>(childStates.at(i)), newDepth, orgDepth, alpha, beta, ply + 1, thread);
             }
         }
-        else if (l == '/')
+        else
+            minValue = MinValue(std::get<0>(childStates.at(i)), newDepth, orgDepth, alpha, beta, ply + 1, thread);
+
+        // Get the maximum of value and minValue. Keep track of the index.
+        if (value < minValue)
         {
-            j = 0;
-            i--;
+            value = minValue;
+            maxIndex = i;
+            thread.updatePv(ply, moves.at(i));
         }
-        else
+
+        // Pruning possibility
+        if (value > beta)
         {
-            s.setBoard(color, l, id, i, j);
-            id++;
-            j++;
+            // Remember quiet moves that caused the prune as killers for this ply
+            const std::tuple<int, std::string, std::string>& action = std::get<2>(childStates.at(i));
+            if (ply < MAX_PLY && parent.isEmpty(std::get<0>(action), std::get<1>(action)) && thread.killers[ply][0] != moves.at(i))
+            {
+                thread.killers[ply][1] = thread.killers[ply][0];
+                thread.killers[ply][0] = moves.at(i);
+            }
+
+            break;
         }
-        index++;
-        l = game->fen.at(index);
-
-        // Update color of new char
-        if (islower(l))
-            color = 'b';
-        else if (isupper(l))
-            color = 'w';
-        else
-            color = '-';
-    }
-
-    // Get to the portion of the string with castling info
-    index += 3;
-    l = game->fen.at(index);
-    while (l != ' ')
-    {
-        if (l == 'K' && s.getPlayerColor() == 'w')
-            s.myKingCanCastle();
-        else if (l == 'K')
-            s.oppKingCanCastle();
-        else if (l == 'Q' && s.getPlayerColor() == 'w')
-            s.myQueenCanCastle();
-        else if (l == 'Q')
-            s.oppQueenCanCastle();
-        else if (l == 'k' && s.getPlayerColor() == 'b')
-            s.myKingCanCastle();
-        else if (l == 'k')
-            s.oppKingCanCastle();
-        else if (l == 'q' && s.getPlayerColor() == 'b')
-            s.myQueenCanCastle();
-        else if (l == 'q')
-            s.oppQueenCanCastle();
-
-        index++;
-        l = game->fen.at(index);
-    }
-
-    // Get to the portion of the string with en passant info
-    index++;
-    l = game->fen.at(index);
-    if (l == '-')
-        s.setEnPassant(-1, "NULL");
-    else
+
+        alpha = std::max(value, alpha);
+    }
+
+    // Get the move that leads to the highest value
+    if (!childStates.empty())
     {
-        index++;
-        std::string file(1, l);
-        int rank = game->fen.at(index) - '0';
+        move = std::make_tuple(std::get<1>(childStates.at(maxIndex)), std::get<2>(childStates.at(maxIndex)));
 
-        std::cout << "En passant space set to " << file << rank << std::endl << std::endl;
+        // Add to history table
+        if (!thread.historyTable.count(move))
+            thread.historyTable[move] = 1;
+        else
+            thread.historyTable[move] = thread.historyTable[move] + 1;
 
-        s.setEnPassant(rank, file);
+        transpositionTable.store(key, scoreToTT(value, ply), depth, (value >= beta) ? TT_LOWER : ((value <= alphaOrig) ? TT_UPPER : TT_EXACT), moves.at(maxIndex));
     }
 
-    // Get to portion of string with halfmove clock info.
-    index += 2;
-    std::string number;
-    while (game->fen.at(index) != ' ')
+    return value;
+}
+
+// Quiescence search for Min: stand pat on the static evaluation or try to improve on it with captures and
+// promotions only, so leaves are never evaluated in the middle of an exchange. In check every evasion is searched.
+int AI::QMinValue(State parent, const int& orgDepth, int alpha, int beta, const int& ply, const int& qsPly, SearchThread& thread)
+{
+    thread.clearPv(ply);
+
+    // Make sure time does not exceed the hard budget for this move, and stop helpers once the main thread is done
+    if (orgDepth != 1 && (stopSearch || (thread.id == 0 && timeManager.hardExpired())))
+        throw (orgDepth - 1);
+
+    thread.nodes++;
+    thread.qsNodes++;
+
+    // Update state so Min-Player is at play
+    parent.switchSides();
+
+    bool inCheck = parent.kingInCheck();
+    int standPat = evaluate(parent, thread, alpha, beta);
+    int value = INFINITE_SCORE;
+
+    if (qsPly >= searchParams.qsMaxPly)
+        return standPat;
+
+    if (!inCheck)
     {
-        number += game->fen.at(index);
-        index++;
+        if (standPat < alpha)
+            return standPat;
+
+        value = standPat;
+        beta = std::min(beta, standPat);
     }
-    s.setMoveTracker(std::stoi(number) / 2);
 
-    // Keep track of both King's position
-    for (int i = 1 ; i <= RANK; i++)
+    StateActionPair childStates = inCheck ? parent.generateChildren() : parent.generateCaptures();
+
+    // Checkmated
+    if (inCheck && childStates.empty())
+        return MATE - ply;
+
+    orderCaptures(parent, childStates);
+
+    for (unsigned int i = 0; i < childStates.size(); i++)
     {
-        for (int j = 0; j < FILE; j++)
+        const std::tuple<int, std::string, std::string>& action = std::get<2>(childStates.at(i));
+
+        if (!inCheck && !parent.isPromotion(std::get<2>(action)))
         {
-            if (s(i, j).letter == 'K' && s.getPlayerColor() == 'w')
+            // Delta: even winning the captured piece outright (and a margin) can't bring the score under beta
+            int captured = (std::get<2>(action) == "EN PASSANT") ? PAWN_VALUE : parent.pieceValue(parent(std::get<0>(action), std::get<1>(action)));
+            if (!isMateScore(beta) && standPat - captured - searchParams.deltaMargin >= beta)
             {
-                s.setMyKingRank(i);
-                s.setMyKingFile(s.convertToFile(j + 1));
+                thread.deltaPrunes++;
+                continue;
             }
-            else if (s(i, j).letter == 'K')
+
+            // Losing captures
+            std::tuple<int, std::string> from = parent.findLocation(std::get<1>(childStates.at(i)));
+            if (parent.staticExchange(std::get<0>(from), std::get<1>(from), action) < 0)
             {
-                s.setOppKingRank(i);
-                s.setOppKingFile(s.convertToFile(j + 1));
+                thread.seePrunes++;
+                continue;
             }
+        }
+
+        int maxValue = QMaxValue(std::get<0>(childStates.at(i)), orgDepth, alpha, beta, ply + 1, qsPly + 1, thread);
+
+        value = std::min(value, maxValue);
+
+        // Pruning possibility
+        if (value < alpha)
+            break;
+
+        beta = std::min(value, beta);
+    }
+
+    return value;
+}
+
+// Quiescence search for Max, see QMinValue
+int AI::QMaxValue(State parent, const int& orgDepth, int alpha, int beta, const int& ply, const int& qsPly, SearchThread& thread)
+{
+    thread.clearPv(ply);
+
+    // Make sure time does not exceed the hard budget for this move, and stop helpers once the main thread is done
+    if (orgDepth != 1 && (stopSearch || (thread.id == 0 && timeManager.hardExpired())))
+        throw (orgDepth - 1);
+
+    thread.nodes++;
+    thread.qsNodes++;
+
+    // Update state so Max-Player is at play
+    parent.switchSides();
+
+    bool inCheck = parent.kingInCheck();
+    int standPat = evaluate(parent, thread, alpha, beta);
+    int value = -INFINITE_SCORE;
+
+    if (qsPly >= searchParams.qsMaxPly)
+        return standPat;
+
+    if (!inCheck)
+    {
+        if (standPat > beta)
+            return standPat;
 
-            if (s(i, j).letter == 'k' && s.getPlayerColor() == 'b')
+        value = standPat;
+        alpha = std::max(alpha, standPat);
+    }
+
+    StateActionPair childStates = inCheck ? parent.generateChildren() : parent.generateCaptures();
+
+    // Checkmated
+    if (inCheck && childStates.empty())
+        return -MATE + ply;
+
+    orderCaptures(parent, childStates);
+
+    for (unsigned int i = 0; i < childStates.size(); i++)
+    {
+        const std::tuple<int, std::string, std::string>& action = std::get<2>(childStates.at(i));
+
+        if (!inCheck && !parent.isPromotion(std::get<2>(action)))
+        {
+            // Delta: even winning the captured piece outright (and a margin) can't lift the score over alpha
+            int captured = (std::get<2>(action) == "EN PASSANT") ? PAWN_VALUE : parent.pieceValue(parent(std::get<0>(action), std::get<1>(action)));
+            if (!isMateScore(alpha) && standPat + captured + searchParams.deltaMargin <= alpha)
             {
-                s.setMyKingRank(i);
-                s.setMyKingFile(s.convertToFile(j + 1));
+                thread.deltaPrunes++;
+                continue;
             }
-            else if (s(i, j).letter == 'k')
+
+            // Losing captures
+            std::tuple<int, std::string> from = parent.findLocation(std::get<1>(childStates.at(i)));
+            if (parent.staticExchange(std::get<0>(from), std::get<1>(from), action) < 0)
             {
-                s.setOppKingRank(i);
-                s.setOppKingFile(s.convertToFile(j + 1));
+                thread.seePrunes++;
+                continue;
             }
         }
+
+        int minValue = QMinValue(std::get<0>(childStates.at(i)), orgDepth, alpha, beta, ply + 1, qsPly + 1, thread);
+
+        value = std::max(value, minValue);
+
+        // Pruning possibility
+        if (value > beta)
+            break;
+
+        alpha = std::max(value, alpha);
     }
 
+    return value;
+}
+
+// Static evaluation from the root player's point of view, read from the evaluation cache when possible.
+// The cache is keyed on the pieces and the side to move, since the network and some endgame evaluators (KPK, KRKP)
+// depend on whose turn it is. The hand-written evaluation is done in two tiers: material and piece-square tables
+// come first, and when they already put the score well outside [alpha, beta] the rest is skipped. Those partial
+// scores are never cached.
+int AI::evaluate(const State& state, SearchThread& thread, const int& alpha, const int& beta)
+{
+    uint64_t key = state.getPieceKey();
+    bool white = (s.getPlayerColor() == 'w');
+    int score;
+
+    if (state.getPlayerColor() == 'b')
+        key ^= zobrist.side;
+
+    thread.evalProbes++;
+    if (evalCache.probe(key, score))
+    {
+        thread.evalHits++;
+        return white ? score : -score;
+    }
+
+    // Known endgames get their own evaluation, whichever evaluator is in use
+    const MaterialEntry& material = thread.materialTable.probe(state);
+    const EndgameEntry* endgame = material.endgame;
+    if (endgame && endgame->evaluate)
+    {
+        score = endgame->evaluate(state, endgame->strongSide);
+        evalCache.store(key, score);
+
+        return white ? score : -score;
+    }
+
+    if (network.isLoaded())
+    {
+        score = network.evaluate(state.getAccumulator(), state.getPlayerColor());
+        if (state.getPlayerColor() == 'b')
+            score = -score;
+        evalCache.store(key, score);
+
+        return white ? score : -score;
+    }
+
+    // Scale down configurations that are hard or impossible to win
+    int scale = endgame ? endgame->scale : SCALE_NORMAL;
+    score = state.stateHeuristic('w') + material.imbalance;
+
+    int lazyScore = (white ? score : -score) * scale / SCALE_NORMAL;
+    if (searchParams.lazyMargin > 0 && (lazyScore < alpha - searchParams.lazyMargin || lazyScore > beta + searchParams.lazyMargin))
+    {
+        thread.lazyExits++;
+
+        // Every so often finish the evaluation anyway: the exit was wrong if the full score lands on the other side of the bound
+        if (thread.lazyExits % LAZY_CHECK_INTERVAL == 0)
+        {
+            score = (score + expensiveTerms(state, thread.pawnTable, NULL)) * scale / SCALE_NORMAL;
+            evalCache.store(key, score);
+
+            int fullScore = white ? score : -score;
+            thread.lazyChecks++;
+            if ((lazyScore < alpha && fullScore >= alpha) || (lazyScore > beta && fullScore <= beta))
+                thread.lazyErrors++;
+        }
+
+        return lazyScore;
+    }
+
+    score = (score + expensiveTerms(state, thread.pawnTable, NULL)) * scale / SCALE_NORMAL;
+    evalCache.store(key, score);
+
+    return white ? score : -score;
+}
+
+// Sorts captures by MVV-LVA: most valuable victim first, then least valuable attacker. Promotions count the new piece.
+void AI::orderCaptures(const State& parent, StateActionPair& childStates)
+{
+    std::vector<std::tuple<int, unsigned int>> scores;
+
+    for (unsigned int i = 0; i < childStates.size(); i++)
+    {
+        const std::tuple<int, std::string, std::string>& action = std::get<2>(childStates.at(i));
+        int score = parent.pieceValue(parent(std::get<0>(action), std::get<1>(action))) * 100 - parent.pieceValue(std::get<1>(childStates.at(i))) / 100;
+
+        if (std::get<2>(action) == "EN PASSANT")
+            score = PAWN_VALUE * 100 - PAWN_VALUE / 100;
+        else if (parent.isPromotion(std::get<2>(action)))
+            score += parent.pieceValue(PieceInfo('-', std::get<2>(action) == "Knight" ? 'N' : std::get<2>(action).at(0), 0)) * 100;
+
+        scores.push_back(std::make_tuple(score, i));
+    }
+
+    std::stable_sort(scores.begin(), scores.end(), [](const std::tuple<int, unsigned int>& lhs, const std::tuple<int, unsigned int>& rhs) {return std::get<0>(lhs) > std::get<0>(rhs);});
+
+    StateActionPair ordered;
+    for (unsigned int i = 0; i < scores.size(); i++)
+        ordered.push_back(std::move(childStates.at(std::get<1>(scores.at(i)))));
+    childStates.swap(ordered);
+
+    return;
+}
+
+// Sorts child states so the transposition table move comes first, then killers, then by history table value.
+// Returns the packed move of every child in the new order.
+std::vector<uint16_t> AI::orderChildren(const State& parent, StateActionPair& childStates, const uint16_t& ttMove, const int& ply, SearchThread& thread)
+{
+    std::vector<std::tuple<int, unsigned int, uint16_t>> scores;
+
+    for (unsigned int i = 0; i < childStates.size(); i++)
+    {
+        const PieceInfo& piece = std::get<1>(childStates.at(i));
+        std::tuple<int, std::string> from = parent.findLocation(piece);
+        uint16_t move = parent.packMove(std::get<0>(from), std::get<1>(from), std::get<2>(childStates.at(i)));
+        int score = 0;
+
+        if (move == ttMove)
+            score = INT_MAX;
+        else if (ply < MAX_PLY && move == thread.killers[ply][0])
+            score = INT_MAX - 1;
+        else if (ply < MAX_PLY && move == thread.killers[ply][1])
+            score = INT_MAX - 2;
+        else
+        {
+            HistoryTable::const_iterator it = thread.historyTable.find(std::make_tuple(piece, std::get<2>(childStates.at(i))));
+            if (it != thread.historyTable.end())
+                score = std::min(it->second, INT_MAX - 3);
+        }
+
+        scores.push_back(std::make_tuple(score, i, move));
+    }
+
+    // Stable so equally scored children keep their shuffled order
+    std::stable_sort(scores.begin(), scores.end(), [](const std::tuple<int, unsigned int, uint16_t>& lhs, const std::tuple<int, unsigned int, uint16_t>& rhs) {return std::get<0>(lhs) > std::get<0>(rhs);});
+
+    StateActionPair ordered;
+    std::vector<uint16_t> moves;
+    for (unsigned int i = 0; i < scores.size(); i++)
+    {
+        ordered.push_back(std::move(childStates.at(std::get<1>(scores.at(i)))));
+        moves.push_back(std::get<2>(scores.at(i)));
+    }
+    childStates.swap(ordered);
+
+    return moves;
+}
+
+// Parses the FEN string and places pieces in state's 2D array
+void AI::initState()
+{
+    // Set up the board from the game's FEN for this player's color
+    s.loadFen(game->fen, player->color);
+
+    if (std::get<0>(s.getEnPassant()) != -1)
+        std::cout << "En passant space set to " << std::get<1>(s.getEnPassant()) << std::get<0>(s.getEnPassant()) << std::endl << std::endl;
+
     return;
 }
 
@@ -16,6 +16,12 @@
 #define FILE 8
 #define WHITE_PAWN_INIT_RANK 2
 #define BLACK_PAWN_INIT_RANK 7
+#define MAX_DEPTH 64
+#define MAX_PLY 128
+
+// An exact hash entry for the root at least this deep (or the depth limit, if lower) is played without searching
+#define INSTANT_HASH_DEPTH 8
+
 #include <cstdlib>
 #include <ctime>
 #include <vector>
@@ -26,6 +32,15 @@
 #include <cctype>
 #include <climits>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <memory>
+#include <functional>
+#include <cmath>
+#include <unordered_map>
 // <<-- /Creer-Merge: includes -->>
 
 namespace cpp_client
@@ -34,7 +49,22 @@ namespace cpp_client
 namespace chess
 {
 
+#include "zobrist.hpp"
+#include "nnue.hpp"
 #include "state.hpp"
+#include "psqt.hpp"
+#include "evaluation.hpp"
+#include "attacks.hpp"
+#include "batch_eval.hpp"
+#include "endgame.hpp"
+#include "score.hpp"
+#include "transposition_table.hpp"
+#include "eval_cache.hpp"
+#include "pawn_table.hpp"
+#include "material_table.hpp"
+#include "search_thread.hpp"
+#include "search_params.hpp"
+#include "time_manager.hpp"
 
 /// <summary>
 /// This is the header file for building your Chess AI
@@ -88,9 +118,23 @@ public:
 
     // <<-- Creer-Merge: methods -->> - Code you add between this comment and the end comment will be preserved between Creer re-runs.
     void initState();
-    MyMove AlphaBetaSearch(const State& parent, const int& depth, const int& qsDepth);
-    int MinValue(State parent, const int& depth, const int& qsDepth, const int& orgDepth, int alpha, int beta);
-    int MaxValue(State parent, const int& depth, const int& qsDepth, const int& orgDepth, int alpha, int beta);
+    int getIntSetting(const std::string& name, const int& defaultValue);
+    void loadSearchParams();
+    bool instantMove(const int& depth);
+    void think(const State& root, const int& depth);
+    SearchThread* bestThread();
+    void printInfo(const SearchThread& thread, const State& root, const int& line, const int& score, const std::vector<uint16_t>& pv);
+    void startPondering(const int& depth);
+    void stopPondering();
+    void searchWorker(SearchThread& thread, const State& root, const int& depth);
+    std::tuple<int, MyMove> AlphaBetaSearch(const State& parent, const int& depth, int alpha, int beta, SearchThread& thread, const std::vector<uint16_t>& excluded);
+    int MinValue(State parent, const int& depth, const int& orgDepth, int alpha, int beta, const int& ply, SearchThread& thread);
+    int MaxValue(State parent, const int& depth, const int& orgDepth, int alpha, int beta, const int& ply, SearchThread& thread);
+    int QMinValue(State parent, const int& orgDepth, int alpha, int beta, const int& ply, const int& qsPly, SearchThread& thread);
+    int QMaxValue(State parent, const int& orgDepth, int alpha, int beta, const int& ply, const int& qsPly, SearchThread& thread);
+    void orderCaptures(const State& parent, StateActionPair& childStates);
+    int evaluate(const State& state, SearchThread& thread, const int& alpha, const int& beta);
+    std::vector<uint16_t> orderChildren(const State& parent, StateActionPair& childStates, const uint16_t& ttMove, const int& ply, SearchThread& thread);
     // void updateState(const Move& move);
     // <<-- /Creer-Merge: methods -->>
 
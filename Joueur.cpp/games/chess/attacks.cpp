@@ -0,0 +1,136 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+static const uint64_t FILE_A_MASK = 0x0101010101010101ULL;
+static const uint64_t FILE_H_MASK = FILE_A_MASK << 7;
+
+// Rank and file steps of each ray direction, in the order of AttackTables::rays
+static const int RAY_RANK_STEP[8] = {1, 0, 1, 1, -1, 0, -1, -1};
+static const int RAY_FILE_STEP[8] = {0, 1, 1, -1, 0, -1, -1, 1};
+
+const AttackTables attackTables;
+
+AttackTables::AttackTables()
+{
+    const int knightRank[8] = {2, 2, 1, 1, -1, -1, -2, -2};
+    const int knightFile[8] = {1, -1, 2, -2, 2, -2, 1, -1};
+
+    for (int rank = 1; rank <= RANK; rank++)
+    {
+        for (int file = 0; file < FILE; file++)
+        {
+            int square = squareIndex(rank, file);
+
+            knight[square] = 0;
+            king[square] = 0;
+
+            for (int i = 0; i < 8; i++)
+            {
+                int r = rank + knightRank[i], f = file + knightFile[i];
+                if (r >= 1 && r <= RANK && f >= 0 && f < FILE)
+                    knight[square] |= 1ULL << squareIndex(r, f);
+
+                r = rank + RAY_RANK_STEP[i];
+                f = file + RAY_FILE_STEP[i];
+                if (r >= 1 && r <= RANK && f >= 0 && f < FILE)
+                    king[square] |= 1ULL << squareIndex(r, f);
+            }
+
+            for (int d = 0; d < 8; d++)
+            {
+                rays[d][square] = 0;
+                for (int r = rank + RAY_RANK_STEP[d], f = file + RAY_FILE_STEP[d]; r >= 1 && r <= RANK && f >= 0 && f < FILE;
+                     r += RAY_RANK_STEP[d], f += RAY_FILE_STEP[d])
+                    rays[d][square] |= 1ULL << squareIndex(r, f);
+            }
+        }
+    }
+}
+
+uint64_t pawnAttacks(const uint64_t& pawns, const int& side)
+{
+    if (side == 0)
+        return ((pawns << 7) & ~FILE_H_MASK) | ((pawns << 9) & ~FILE_A_MASK);
+
+    return ((pawns >> 9) & ~FILE_H_MASK) | ((pawns >> 7) & ~FILE_A_MASK);
+}
+
+// Ray in one direction cut off behind its first blocker: the nearest blocker is the lowest set bit on rays
+// running up the board and the highest on rays running down
+static uint64_t rayAttacks(const int& direction, const int& square, const uint64_t& occupied)
+{
+    uint64_t ray = attackTables.rays[direction][square];
+    uint64_t blockers = ray & occupied;
+
+    if (blockers)
+    {
+        int blocker = (direction < 4) ? __builtin_ctzll(blockers) : 63 - __builtin_clzll(blockers);
+        ray ^= attackTables.rays[direction][blocker];
+    }
+
+    return ray;
+}
+
+uint64_t bishopAttacks(const int& square, const uint64_t& occupied)
+{
+    return rayAttacks(2, square, occupied) | rayAttacks(3, square, occupied) | rayAttacks(6, square, occupied) | rayAttacks(7, square, occupied);
+}
+
+uint64_t rookAttacks(const int& square, const uint64_t& occupied)
+{
+    return rayAttacks(0, square, occupied) | rayAttacks(1, square, occupied) | rayAttacks(4, square, occupied) | rayAttacks(5, square, occupied);
+}
+
+AttackMaps::AttackMaps(const State& state)
+{
+    state.pieceBitboards(pieces);
+
+    for (int side = 0; side < 2; side++)
+    {
+        occupied[side] = 0;
+        for (int piece = 6 * side; piece < 6 * side + 6; piece++)
+            occupied[side] |= pieces[piece];
+    }
+
+    uint64_t both = occupied[0] | occupied[1];
+
+    for (int side = 0; side < 2; side++)
+    {
+        uint64_t king = pieces[6 * side + 5];
+
+        count[side] = 0;
+        pawns[side] = pawnAttacks(pieces[6 * side], side);
+        kingZone[side] = king ? (king | attackTables.king[__builtin_ctzll(king)]) : 0;
+        all[side] = pawns[side] | (king ? attackTables.king[__builtin_ctzll(king)] : 0);
+
+        for (int t = 1; t <= 4; t++)
+        {
+            for (uint64_t remaining = pieces[6 * side + t]; remaining; remaining &= remaining - 1)
+            {
+                int square = __builtin_ctzll(remaining);
+                uint64_t reach;
+
+                if (t == 1)
+                    reach = attackTables.knight[square];
+                else if (t == 2)
+                    reach = bishopAttacks(square, both);
+                else if (t == 3)
+                    reach = rookAttacks(square, both);
+                else
+                    reach = bishopAttacks(square, both) | rookAttacks(square, both);
+
+                type[side][count[side]] = t;
+                attacks[side][count[side]] = reach;
+                count[side]++;
+                all[side] |= reach;
+            }
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,57 @@
+#ifndef ATTACKS_HPP
+#define ATTACKS_HPP
+
+// Default attack-based weights (in centipawns) for knights, bishops, rooks and queens, the starting point of the
+// tunable evalParams: per safe square a piece reaches, per square of the enemy king zone it hits, and per piece
+// left attacked without a defender
+const int MOBILITY_MG[4] = {4, 4, 2, 1};
+const int MOBILITY_EG[4] = {4, 5, 4, 2};
+const int KING_ATTACK_WEIGHT[4] = {5, 5, 6, 8};
+#define HANGING_PIECE_PENALTY 20
+
+// Squares reached from each square by a knight and a king, and the rays in each of the eight directions.
+// Bitboards use bit squareIndex(rank, file), so a1 is bit 0 and h8 bit 63.
+struct AttackTables
+{
+    uint64_t knight[RANK * FILE];
+    uint64_t king[RANK * FILE];
+
+    // Directions 0-3 (north, east, north-east, north-west) run towards higher bits, 4-7 (south, west, south-west,
+    // south-east) towards lower ones
+    uint64_t rays[8][RANK * FILE];
+
+    AttackTables();
+};
+
+extern const AttackTables attackTables;
+
+// Squares attacked by a set of pawns of a side (0 = white, 1 = black)
+uint64_t pawnAttacks(const uint64_t& pawns, const int& side);
+
+// Squares a slider on a square attacks, up to and including the first occupied square in each direction
+uint64_t bishopAttacks(const int& square, const uint64_t& occupied);
+uint64_t rookAttacks(const int& square, const uint64_t& occupied);
+
+// Every piece's attacks in a position, built once per evaluation from the board. Index 0 is white, 1 is black.
+struct AttackMaps
+{
+    // Pieces by pieceIndex, and by side
+    uint64_t pieces[12];
+    uint64_t occupied[2];
+
+    // Knights, bishops, rooks and queens (at most 15 a side, even after promotions) with the squares each one attacks
+    int count[2];
+    int type[2][16];
+    uint64_t attacks[2][16];
+
+    // Union of all attacks of a side (pawns and king included), and of its pawns alone
+    uint64_t all[2];
+    uint64_t pawns[2];
+
+    // The king's square and the squares around it
+    uint64_t kingZone[2];
+
+    explicit AttackMaps(const State& state);
+};
+
+#endif
@@ -0,0 +1,250 @@
+// Included ahead of ai.hpp, whose FILE macro would break the C stdio declarations they pull in
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+const char* batchKernels()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE4_1__)
+    return "SSE4.1";
+#else
+    return "scalar";
+#endif
+}
+
+// sums[i] += table[features[i]] for every position
+static void gatherAdd(float* sums, const int16_t* features, const float* table, const int& count)
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i index = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(features + i)));
+        _mm256_storeu_ps(sums + i, _mm256_add_ps(_mm256_loadu_ps(sums + i), _mm256_i32gather_ps(table, index, 4)));
+    }
+#elif defined(__SSE4_1__)
+    // No gather instruction: four scalar lookups, then one vector add
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 values = _mm_set_ps(table[features[i + 3]], table[features[i + 2]], table[features[i + 1]], table[features[i]]);
+        _mm_storeu_ps(sums + i, _mm_add_ps(_mm_loadu_ps(sums + i), values));
+    }
+#endif
+
+    for (; i < count; i++)
+        sums[i] += table[features[i]];
+
+    return;
+}
+
+// sums[i] += weight * coefficients[i] for every position
+static void scaleAdd(float* sums, const int16_t* coefficients, const float& weight, const int& count)
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256 scale = _mm256_set1_ps(weight);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(coefficients + i))));
+        _mm256_storeu_ps(sums + i, _mm256_add_ps(_mm256_loadu_ps(sums + i), _mm256_mul_ps(values, scale)));
+    }
+#elif defined(__SSE4_1__)
+    __m128 scale = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 values = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(coefficients + i))));
+        _mm_storeu_ps(sums + i, _mm_add_ps(_mm_loadu_ps(sums + i), _mm_mul_ps(values, scale)));
+    }
+#endif
+
+    for (; i < count; i++)
+        sums[i] += weight * coefficients[i];
+
+    return;
+}
+
+// Sum of factors[i] * coefficients[i] over every position
+static float dot(const float* factors, const int16_t* coefficients, const int& count)
+{
+    float total = 0.0f;
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256 sum = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(coefficients + i))));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(values, _mm256_loadu_ps(factors + i)));
+    }
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    total = _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+#elif defined(__SSE4_1__)
+    __m128 sum = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 values = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(coefficients + i))));
+        sum = _mm_add_ps(sum, _mm_mul_ps(values, _mm_loadu_ps(factors + i)));
+    }
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    total = _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+#endif
+
+    for (; i < count; i++)
+        total += factors[i] * coefficients[i];
+
+    return total;
+}
+
+// Index of the first parameter of an EvalParams member
+#define PARAM_INDEX(member) ((int)(offsetof(EvalParams, member) / sizeof(int)))
+
+// Piece type and table square (from the piece's own side) of a piece-square feature, and its sign for white
+static void decodeFeature(const int& feature, int& type, int& square, float& sign)
+{
+    int piece = feature / (RANK * FILE);
+
+    type = piece % 6;
+    square = (piece < 6) ? feature % (RANK * FILE) : (feature % (RANK * FILE)) ^ 56;
+    sign = (piece < 6) ? 1.0f : -1.0f;
+
+    return;
+}
+
+EvalBatch::EvalBatch(const int& positions)
+{
+    capacity = (positions + BATCH_WIDTH - 1) / BATCH_WIDTH * BATCH_WIDTH;
+    size = 0;
+
+    pieceSquares.assign(BATCH_PIECE_SLOTS * capacity, BATCH_EMPTY_FEATURE);
+    coefficients.assign(BATCH_FEATURE_COUNT * capacity, 0);
+    middlegame.assign(capacity, 0.0f);
+}
+
+void EvalBatch::clear()
+{
+    std::fill(pieceSquares.begin(), pieceSquares.end(), BATCH_EMPTY_FEATURE);
+    std::fill(coefficients.begin(), coefficients.end(), 0);
+    std::fill(middlegame.begin(), middlegame.end(), 0.0f);
+    size = 0;
+
+    return;
+}
+
+int EvalBatch::add(const State& state, const EvalTrace& trace)
+{
+    int index = size++;
+    int slot = 0;
+
+    for (int i = 1; i <= RANK; i++)
+    {
+        for (int j = 0; j < FILE; j++)
+        {
+            int piece = pieceIndex(state(i, j).letter);
+            if (piece != -1 && slot < BATCH_PIECE_SLOTS)
+                pieceSquares[(slot++) * capacity + index] = piece * RANK * FILE + squareIndex(i, j);
+        }
+    }
+
+    for (int f = 0; f < BATCH_FEATURE_COUNT; f++)
+        coefficients[f * capacity + index] = trace.counts[EVAL_FEATURE_OFFSET + f];
+
+    middlegame[index] = (float)trace.phase / MAX_PHASE;
+
+    return index;
+}
+
+void EvalBatch::evaluate(const float* params, float* scores) const
+{
+    std::vector<float> mg(capacity, 0.0f), eg(capacity, 0.0f), flat(capacity, 0.0f);
+    std::vector<float> tableMg(BATCH_EMPTY_FEATURE + 1, 0.0f), tableEg(BATCH_EMPTY_FEATURE + 1, 0.0f);
+
+    // Piece value plus table entry for every piece on every square, signed for white's point of view
+    for (int feature = 0; feature < BATCH_EMPTY_FEATURE; feature++)
+    {
+        int type, square;
+        float sign;
+        decodeFeature(feature, type, square, sign);
+
+        tableMg[feature] = sign * (params[PARAM_INDEX(pieceMg) + type] + params[PARAM_INDEX(psqtMg) + type * RANK * FILE + square]);
+        tableEg[feature] = sign * (params[PARAM_INDEX(pieceEg) + type] + params[PARAM_INDEX(psqtEg) + type * RANK * FILE + square]);
+    }
+
+    for (int s = 0; s < BATCH_PIECE_SLOTS; s++)
+    {
+        gatherAdd(mg.data(), &pieceSquares[s * capacity], tableMg.data(), size);
+        gatherAdd(eg.data(), &pieceSquares[s * capacity], tableEg.data(), size);
+    }
+
+    for (int f = 0; f < BATCH_FEATURE_COUNT; f++)
+    {
+        int taper = evalParamTaper(EVAL_FEATURE_OFFSET + f);
+        float* sums = (taper == TAPER_MG) ? mg.data() : ((taper == TAPER_EG) ? eg.data() : flat.data());
+        scaleAdd(sums, &coefficients[f * capacity], params[EVAL_FEATURE_OFFSET + f], size);
+    }
+
+    for (int i = 0; i < size; i++)
+        scores[i] = mg[i] * middlegame[i] + eg[i] * (1.0f - middlegame[i]) + flat[i];
+
+    return;
+}
+
+void EvalBatch::gradient(const float* factors, float* gradient) const
+{
+    std::vector<float> factorMg(capacity, 0.0f), factorEg(capacity, 0.0f);
+    std::vector<float> tableMg(BATCH_EMPTY_FEATURE + 1, 0.0f), tableEg(BATCH_EMPTY_FEATURE + 1, 0.0f);
+
+    for (int i = 0; i < size; i++)
+    {
+        factorMg[i] = factors[i] * middlegame[i];
+        factorEg[i] = factors[i] * (1.0f - middlegame[i]);
+    }
+
+    for (int f = 0; f < BATCH_FEATURE_COUNT; f++)
+    {
+        int taper = evalParamTaper(EVAL_FEATURE_OFFSET + f);
+        const float* scale = (taper == TAPER_MG) ? factorMg.data() : ((taper == TAPER_EG) ? factorEg.data() : factors);
+        gradient[EVAL_FEATURE_OFFSET + f] += dot(scale, &coefficients[f * capacity], size);
+    }
+
+    // Scatter onto the piece-square features first, then hand each feature's total to its two parameters
+    for (int s = 0; s < BATCH_PIECE_SLOTS; s++)
+    {
+        const int16_t* features = &pieceSquares[s * capacity];
+        for (int i = 0; i < size; i++)
+        {
+            tableMg[features[i]] += factorMg[i];
+            tableEg[features[i]] += factorEg[i];
+        }
+    }
+
+    for (int feature = 0; feature < BATCH_EMPTY_FEATURE; feature++)
+    {
+        int type, square;
+        float sign;
+        decodeFeature(feature, type, square, sign);
+
+        gradient[PARAM_INDEX(pieceMg) + type] += sign * tableMg[feature];
+        gradient[PARAM_INDEX(psqtMg) + type * RANK * FILE + square] += sign * tableMg[feature];
+        gradient[PARAM_INDEX(pieceEg) + type] += sign * tableEg[feature];
+        gradient[PARAM_INDEX(psqtEg) + type * RANK * FILE + square] += sign * tableEg[feature];
+    }
+
+    return;
+}
+
+}
+}
@@ -0,0 +1,55 @@
+#ifndef BATCH_EVAL_HPP
+#define BATCH_EVAL_HPP
+
+// Most pieces a board can hold, and the piece-square feature of an empty slot (one past the last real one)
+#define BATCH_PIECE_SLOTS 32
+#define BATCH_EMPTY_FEATURE (12 * RANK * FILE)
+
+// Positions per kernel step of the widest vector unit; batch capacities are rounded up to a multiple of it
+#define BATCH_WIDTH 8
+
+// The parameters after the piece values and piece-square tables, which the batch keeps as plain coefficients
+#define BATCH_FEATURE_COUNT (EVAL_PARAM_COUNT - EVAL_FEATURE_OFFSET)
+
+// Many independent positions laid out structure-of-arrays for the hand-written evaluation: row r of a table
+// holds entry r of every position, so each kernel streams across positions with full vector width. Scores are
+// the unrounded traced evaluation (from white's point of view) under any set of parameters, which is what the
+// tuner and bulk analysis need.
+class EvalBatch
+{
+    private:
+        int capacity;
+        int size;
+
+        // Piece-square feature (pieceIndex * 64 + squareIndex) of each piece, BATCH_PIECE_SLOTS rows
+        std::vector<int16_t> pieceSquares;
+
+        // Coefficient of each parameter from EVAL_FEATURE_OFFSET on, BATCH_FEATURE_COUNT rows
+        std::vector<int16_t> coefficients;
+
+        // Middlegame share of the phase blend (phase / MAX_PHASE)
+        std::vector<float> middlegame;
+
+    public:
+        explicit EvalBatch(const int& positions);
+
+        int getSize() const {return size;}
+        int getCapacity() const {return capacity;}
+        bool full() const {return size == capacity;}
+        void clear();
+
+        // Append a position given its state and the trace of its evaluation; returns its index in the batch
+        int add(const State& state, const EvalTrace& trace);
+
+        // Score every position with the given parameters (EVAL_PARAM_COUNT of them, in EvalParams order)
+        void evaluate(const float* params, float* scores) const;
+
+        // Add the derivative of sum(factors[i] * score[i]) by every parameter to gradient
+        void gradient(const float* factors, float* gradient) const;
+};
+
+// Instruction set the batch kernels were compiled for: AVX2 or SSE4.1 only when the compiler targets them
+// (-DNATIVE_ARCH=ON), plain loops otherwise
+const char* batchKernels();
+
+#endif
@@ -0,0 +1,348 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+// Results while classifying king and pawn against king, as bits so that the results of all moves can be OR'd
+#define KPK_INVALID 0
+#define KPK_UNKNOWN 1
+#define KPK_DRAW 2
+#define KPK_WIN 4
+
+// White king, black king, side to move, and a white pawn on files a-d, ranks 2-7
+#define KPK_SIZE (64 * 64 * 2 * 4 * 8)
+
+static int rankOf(const int& square) {return square / FILE;}
+static int fileOf(const int& square) {return square % FILE;}
+static int distance(const int& a, const int& b) {return std::max(abs(rankOf(a) - rankOf(b)), abs(fileOf(a) - fileOf(b)));}
+
+static int kpkIndex(const int& white, const int& black, const int& toMove, const int& pawn)
+{
+    return white | (black << 6) | (toMove << 12) | (fileOf(pawn) << 13) | (rankOf(pawn) << 15);
+}
+
+// A white pawn attacks diagonally upwards
+static bool kpkPawnAttacks(const int& pawn, const int& square) {return rankOf(square) == rankOf(pawn) + 1 && abs(fileOf(square) - fileOf(pawn)) == 1;}
+
+// Result of every king and pawn against king position, white having the pawn. Built by retrograde analysis:
+// positions are marked won or drawn directly where that is obvious, then from the results of their moves until
+// nothing changes. Anything still unknown at the end is a draw.
+static std::vector<uint8_t> buildKpk()
+{
+    std::vector<uint8_t> results(KPK_SIZE, KPK_INVALID);
+
+    // Kings step to the up to eight neighbouring squares
+    std::vector<std::vector<int>> kingSteps(RANK * FILE);
+    for (int from = 0; from < RANK * FILE; from++)
+    {
+        for (int to = 0; to < RANK * FILE; to++)
+        {
+            if (distance(from, to) == 1)
+                kingSteps[from].push_back(to);
+        }
+    }
+
+    for (int pawn = 0; pawn < RANK * FILE; pawn++)
+    {
+        if (fileOf(pawn) > 3 || rankOf(pawn) < 1 || rankOf(pawn) > 6)
+            continue;
+
+        for (int white = 0; white < RANK * FILE; white++)
+        {
+            for (int black = 0; black < RANK * FILE; black++)
+            {
+                for (int toMove = 0; toMove < 2; toMove++)
+                {
+                    uint8_t& result = results[kpkIndex(white, black, toMove, pawn)];
+                    int queening = pawn + FILE;
+
+                    // Kings touching or on the pawn, or the side not to move in check
+                    if (distance(white, black) <= 1 || white == pawn || black == pawn || (toMove == 0 && kpkPawnAttacks(pawn, black)))
+                        result = KPK_INVALID;
+
+                    // White promotes without the new queen being taken
+                    else if (toMove == 0 && rankOf(pawn) == 6 && white != queening && black != queening
+                             && (distance(black, queening) > 1 || distance(white, queening) == 1))
+                        result = KPK_WIN;
+
+                    else if (toMove == 1)
+                    {
+                        bool canMove = false, takesPawn = false;
+
+                        for (unsigned int i = 0; i < kingSteps[black].size(); i++)
+                        {
+                            int to = kingSteps[black][i];
+                            if (distance(to, white) > 1 && !kpkPawnAttacks(pawn, to))
+                                canMove = true;
+                            if (to == pawn && distance(to, white) > 1)
+                                takesPawn = true;
+                        }
+
+                        // Stalemate, or the pawn falls
+                        result = (!canMove || takesPawn) ? KPK_DRAW : KPK_UNKNOWN;
+                    }
+                    else
+                        result = KPK_UNKNOWN;
+                }
+            }
+        }
+    }
+
+    for (bool changed = true; changed; )
+    {
+        changed = false;
+
+        for (int pawn = 0; pawn < RANK * FILE; pawn++)
+        {
+            if (fileOf(pawn) > 3 || rankOf(pawn) < 1 || rankOf(pawn) > 6)
+                continue;
+
+            for (int white = 0; white < RANK * FILE; white++)
+            {
+                for (int black = 0; black < RANK * FILE; black++)
+                {
+                    for (int toMove = 0; toMove < 2; toMove++)
+                    {
+                        uint8_t& result = results[kpkIndex(white, black, toMove, pawn)];
+                        int moves = KPK_INVALID;
+
+                        if (result != KPK_UNKNOWN)
+                            continue;
+
+                        if (toMove == 0)
+                        {
+                            for (unsigned int i = 0; i < kingSteps[white].size(); i++)
+                                moves |= results[kpkIndex(kingSteps[white][i], black, 1, pawn)];
+
+                            // Pushes onto a king are invalid positions, so they add nothing
+                            if (rankOf(pawn) < 6)
+                            {
+                                int push = pawn + FILE;
+                                moves |= results[kpkIndex(white, black, 1, push)];
+                                if (rankOf(pawn) == 1 && push != white && push != black)
+                                    moves |= results[kpkIndex(white, black, 1, push + FILE)];
+                            }
+                        }
+                        else
+                        {
+                            for (unsigned int i = 0; i < kingSteps[black].size(); i++)
+                                moves |= results[kpkIndex(white, kingSteps[black][i], 0, pawn)];
+                        }
+
+                        // White needs one winning move; black needs one drawing move, and loses once every move loses
+                        int good = (toMove == 0) ? KPK_WIN : KPK_DRAW;
+                        int bad = (toMove == 0) ? KPK_DRAW : KPK_WIN;
+                        uint8_t classified = (moves & good) ? good : ((moves & KPK_UNKNOWN) ? KPK_UNKNOWN : bad);
+
+                        if (classified != KPK_UNKNOWN)
+                        {
+                            result = classified;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return results;
+}
+
+static const std::vector<uint8_t> kpkResults = buildKpk();
+
+bool kpkWin(const int& strongSide, const int& sideToMove, int strongKing, int weakKing, int pawn)
+{
+    // Look the position up with the pawn white and on the queen's side
+    if (strongSide == 1)
+    {
+        strongKing ^= 56;
+        weakKing ^= 56;
+        pawn ^= 56;
+    }
+    if (fileOf(pawn) > 3)
+    {
+        strongKing ^= 7;
+        weakKing ^= 7;
+        pawn ^= 7;
+    }
+
+    int toMove = (sideToMove == strongSide) ? 0 : 1;
+
+    return kpkResults[kpkIndex(strongKing, weakKing, toMove, pawn)] == KPK_WIN;
+}
+
+// Bonus for driving the losing king to the edge of the board, and for bringing the kings together
+static int pushToEdge(const int& square) {return 100 - 15 * (std::min(fileOf(square), FILE - 1 - fileOf(square)) + std::min(rankOf(square), RANK - 1 - rankOf(square)));}
+static int pushClose(const int& a, const int& b) {return 140 - 20 * distance(a, b);}
+
+static int whitePointOfView(const int& score, const int& strongSide) {return (strongSide == 0) ? score : -score;}
+
+static bool darkSquare(const int& square) {return (rankOf(square) + fileOf(square)) % 2 == 0;}
+
+// Enough material to force mate against a bare king: drive the king to the edge and close in
+static int evaluateKXK(const State& state, const int& strongSide)
+{
+    uint64_t pieces[12];
+    state.pieceBitboards(pieces);
+
+    int strongKing = __builtin_ctzll(pieces[6 * strongSide + 5]);
+    int weakKing = __builtin_ctzll(pieces[6 * (1 - strongSide) + 5]);
+
+    // Bishops alone only mate if they stand on both colours
+    uint64_t bishops = pieces[6 * strongSide + 2];
+    uint64_t others = pieces[6 * strongSide + 1] | pieces[6 * strongSide + 3] | pieces[6 * strongSide + 4];
+    if (!others)
+    {
+        bool dark = false, light = false;
+        for (uint64_t remaining = bishops; remaining; remaining &= remaining - 1)
+        {
+            if (darkSquare(__builtin_ctzll(remaining)))
+                dark = true;
+            else
+                light = true;
+        }
+        if (!(dark && light))
+            return 0;
+    }
+
+    int score = KNOWN_WIN + state.getMaterial((strongSide == 0) ? 'w' : 'b') + pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+
+    return whitePointOfView(score, strongSide);
+}
+
+// Bishop and knight: the mate only works in a corner of the bishop's colour, so drive the king there
+static int evaluateKBNK(const State& state, const int& strongSide)
+{
+    uint64_t pieces[12];
+    state.pieceBitboards(pieces);
+
+    int strongKing = __builtin_ctzll(pieces[6 * strongSide + 5]);
+    int weakKing = __builtin_ctzll(pieces[6 * (1 - strongSide) + 5]);
+    int bishop = __builtin_ctzll(pieces[6 * strongSide + 2]);
+
+    // a1 and h8 are dark, a8 and h1 light
+    int cornerA = darkSquare(bishop) ? squareIndex(1, 0) : squareIndex(8, 0);
+    int cornerB = darkSquare(bishop) ? squareIndex(8, 7) : squareIndex(1, 7);
+    int toCorner = std::min(abs(rankOf(weakKing) - rankOf(cornerA)) + abs(fileOf(weakKing) - fileOf(cornerA)),
+                            abs(rankOf(weakKing) - rankOf(cornerB)) + abs(fileOf(weakKing) - fileOf(cornerB)));
+
+    int score = KNOWN_WIN + state.getMaterial((strongSide == 0) ? 'w' : 'b') + 20 * (14 - toCorner) + pushClose(strongKing, weakKing);
+
+    return whitePointOfView(score, strongSide);
+}
+
+// King and pawn against king: exact, from the table
+static int evaluateKPK(const State& state, const int& strongSide)
+{
+    uint64_t pieces[12];
+    state.pieceBitboards(pieces);
+
+    int strongKing = __builtin_ctzll(pieces[6 * strongSide + 5]);
+    int weakKing = __builtin_ctzll(pieces[6 * (1 - strongSide) + 5]);
+    int pawn = __builtin_ctzll(pieces[6 * strongSide]);
+    int sideToMove = (state.getPlayerColor() == 'w') ? 0 : 1;
+
+    if (!kpkWin(strongSide, sideToMove, strongKing, weakKing, pawn))
+        return 0;
+
+    int relativeRank = (strongSide == 0) ? rankOf(pawn) : RANK - 1 - rankOf(pawn);
+
+    return whitePointOfView(KNOWN_WIN + PAWN_VALUE + 10 * relativeRank, strongSide);
+}
+
+// Rook against pawn: won unless the pawn is far advanced with its king beside it and the other king is far away
+static int evaluateKRKP(const State& state, const int& strongSide)
+{
+    uint64_t pieces[12];
+    state.pieceBitboards(pieces);
+
+    // Seen from the rook's side, so the pawn runs towards the first rank
+    int flip = (strongSide == 0) ? 0 : 56;
+    int strongKing = __builtin_ctzll(pieces[6 * strongSide + 5]) ^ flip;
+    int weakKing = __builtin_ctzll(pieces[6 * (1 - strongSide) + 5]) ^ flip;
+    int rook = __builtin_ctzll(pieces[6 * strongSide + 3]) ^ flip;
+    int pawn = __builtin_ctzll(pieces[6 * (1 - strongSide)]) ^ flip;
+    int queening = fileOf(pawn);
+    int strongToMove = (state.getPlayerColor() == ((strongSide == 0) ? 'w' : 'b')) ? 1 : 0;
+    int score;
+
+    // The rook's king stands in front of the pawn, or the pawn's king is too far from both pawn and rook
+    if (fileOf(strongKing) == fileOf(pawn) && rankOf(strongKing) < rankOf(pawn))
+        score = ROOK_VALUE - distance(strongKing, pawn);
+    else if (distance(weakKing, pawn) >= 3 + (1 - strongToMove) && distance(weakKing, rook) >= 3)
+        score = ROOK_VALUE - distance(strongKing, pawn);
+
+    // An advanced pawn next to its king with the other king out of reach is drawish
+    else if (rankOf(weakKing) <= 2 && distance(weakKing, pawn) == 1 && rankOf(strongKing) >= 3 && distance(strongKing, pawn) > 2 + strongToMove)
+        score = 80 - 8 * distance(strongKing, pawn);
+    else
+        score = 200 - 8 * (distance(strongKing, pawn - FILE) - distance(weakKing, pawn - FILE) - distance(pawn, queening));
+
+    return whitePointOfView(score, strongSide);
+}
+
+const Endgames endgames;
+
+Endgames::Endgames()
+{
+    const char* mating[] = {"KQK", "KRK", "KQQK", "KQRK", "KRRK", "KQBK", "KQNK", "KRBK", "KRNK", "KBBK"};
+    for (unsigned int i = 0; i < sizeof(mating) / sizeof(mating[0]); i++)
+        add(mating[i], evaluateKXK, SCALE_NORMAL, false);
+
+    add("KBNK", evaluateKBNK, SCALE_NORMAL, false);
+    add("KPK", evaluateKPK, SCALE_NORMAL, false);
+    add("KRKP", evaluateKRKP, SCALE_NORMAL, false);
+
+    // Nobody can mate at all
+    add("KK", NULL, SCALE_DRAW, true);
+    add("KNK", NULL, SCALE_DRAW, true);
+    add("KBK", NULL, SCALE_DRAW, true);
+
+    // Mate is possible but cannot be forced
+    add("KNNK", NULL, SCALE_DRAW, false);
+    add("KNKN", NULL, SCALE_DRAW, false);
+    add("KBKN", NULL, SCALE_DRAW, false);
+    add("KBKB", NULL, SCALE_DRAW, false);
+
+    // Usually held by the weaker side
+    add("KRKN", NULL, SCALE_DRAWISH, false);
+    add("KRKB", NULL, SCALE_DRAWISH, false);
+    add("KRKR", NULL, SCALE_DRAWISH, false);
+    add("KQKQ", NULL, SCALE_DRAWISH, false);
+    add("KRNKR", NULL, SCALE_DRAWISH, false);
+    add("KRBKR", NULL, SCALE_DRAWISH, false);
+}
+
+void Endgames::add(const std::string& code, EndgameFunction evaluate, const int& scale, const bool& insufficient)
+{
+    size_t weak = code.find('K', 1);
+
+    for (int strongSide = 0; strongSide < 2; strongSide++)
+    {
+        uint64_t key = 0;
+
+        // The stronger side's pieces are white for strongSide 0 and black for 1
+        for (size_t i = 0; i < code.size(); i++)
+        {
+            bool white = (i < weak) == (strongSide == 0);
+            key += materialKeyUnit(pieceIndex(white ? code[i] : (char)tolower(code[i])));
+        }
+
+        EndgameEntry entry = {evaluate, strongSide, scale, insufficient};
+        table.insert(std::make_pair(key, entry));
+    }
+
+    return;
+}
+
+const EndgameEntry* Endgames::probe(const uint64_t& materialKey) const
+{
+    std::unordered_map<uint64_t, EndgameEntry>::const_iterator found = table.find(materialKey);
+
+    return (found == table.end()) ? NULL : &found->second;
+}
+
+}
+}
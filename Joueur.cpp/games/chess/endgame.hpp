@@ -0,0 +1,54 @@
+#ifndef ENDGAME_HPP
+#define ENDGAME_HPP
+
+// Material signature of a position: the count of every piece (by pieceIndex) in four bits of its own, so each
+// configuration has a distinct key. States keep it up to date as squares change.
+#define MATERIAL_KEY_BITS 4
+inline uint64_t materialKeyUnit(const int& piece) {return 1ULL << (MATERIAL_KEY_BITS * piece);}
+
+// Scale factors for the ordinary evaluation, out of SCALE_NORMAL
+#define SCALE_NORMAL 64
+#define SCALE_DRAWISH 16
+#define SCALE_DRAW 0
+
+// Base score of an endgame known to be won: above anything the ordinary evaluation reaches, below mate scores
+#define KNOWN_WIN 10000
+
+// Specialised evaluation of an endgame (in centipawns, from white's point of view) given the side with the
+// extra material, 0 = white and 1 = black
+typedef int (*EndgameFunction)(const State& state, const int& strongSide);
+
+// What the evaluation does with a material configuration: either a specialised evaluator replaces it, or the
+// ordinary evaluation is scaled. Insufficient material (bare kings, a lone minor) is a draw outright.
+struct EndgameEntry
+{
+    EndgameFunction evaluate;
+    int strongSide;
+    int scale;
+    bool insufficient;
+};
+
+// Material configurations with endgame knowledge, looked up by material key. Filled once at startup.
+class Endgames
+{
+    private:
+        std::unordered_map<uint64_t, EndgameEntry> table;
+
+        // Add a configuration written like "KBNK": the pieces of the stronger side, then those of the weaker,
+        // each starting with its king. Both colourings are added.
+        void add(const std::string& code, EndgameFunction evaluate, const int& scale, const bool& insufficient);
+
+    public:
+        Endgames();
+
+        // Entry for a material key, NULL for the (common) configurations without one
+        const EndgameEntry* probe(const uint64_t& materialKey) const;
+};
+
+extern const Endgames endgames;
+
+// True if king and pawn against king is won for the side with the pawn (0 = white, 1 = black), given the side to
+// move and the squares (squareIndex) of the stronger king, the weaker king and the pawn
+bool kpkWin(const int& strongSide, const int& sideToMove, int strongKing, int weakKing, int pawn);
+
+#endif
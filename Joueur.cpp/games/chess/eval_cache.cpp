@@ -0,0 +1,61 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+EvalCache::EvalCache()
+{
+    size = 0;
+}
+
+void EvalCache::resize(const int& megabytes)
+{
+    uint64_t entries = ((uint64_t)std::max(1, megabytes) << 20) / sizeof(std::atomic<uint64_t>);
+
+    size = 1;
+    while (size * 2 <= entries)
+        size *= 2;
+
+    table.reset(new std::atomic<uint64_t>[size]);
+    clear();
+
+    return;
+}
+
+void EvalCache::clear()
+{
+    for (uint64_t i = 0; i < size; i++)
+        table[i].store(0, std::memory_order_relaxed);
+
+    return;
+}
+
+bool EvalCache::probe(const uint64_t& key, int& score) const
+{
+    if (size == 0)
+        return false;
+
+    uint64_t entry = table[key & (size - 1)].load(std::memory_order_relaxed);
+
+    if (entry == 0 || (entry & 0xFFFFFFFF00000000ULL) != (key & 0xFFFFFFFF00000000ULL))
+        return false;
+
+    score = (int)(uint32_t)entry;
+
+    return true;
+}
+
+void EvalCache::store(const uint64_t& key, const int& score)
+{
+    if (size == 0)
+        return;
+
+    table[key & (size - 1)].store((key & 0xFFFFFFFF00000000ULL) | (uint32_t)score, std::memory_order_relaxed);
+
+    return;
+}
+
+}
+}
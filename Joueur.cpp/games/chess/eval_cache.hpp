@@ -0,0 +1,28 @@
+#ifndef EVAL_CACHE_HPP
+#define EVAL_CACHE_HPP
+
+// Default size of the evaluation cache (in MB), overridable with eval_cache=<MB>
+#define DEFAULT_EVAL_CACHE_SIZE 8
+
+// Lossy direct-mapped cache of static evaluations keyed by the Zobrist key of the pieces on the board and the side to move.
+// Each entry packs the upper half of the key with the score in a single atomic word, so threads share it
+// without locks and a collision simply overwrites the older position.
+class EvalCache
+{
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> table;
+        uint64_t size;
+
+    public:
+        EvalCache();
+
+        // Reallocate the cache to the largest power of two number of entries that fits in the given size
+        void resize(const int& megabytes);
+        void clear();
+
+        // Scores are stored from white's point of view
+        bool probe(const uint64_t& key, int& score) const;
+        void store(const uint64_t& key, const int& score);
+};
+
+#endif
@@ -0,0 +1,235 @@
+#include <fstream>
+#include <sstream>
+
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+EvalParams evalParams;
+
+#define TERM(member, taper) {#member, (int)(offsetof(EvalParams, member) / sizeof(int)), (int)(sizeof(((EvalParams*)0)->member) / sizeof(int)), taper}
+
+const EvalTerm EVAL_TERMS[] =
+{
+    TERM(pieceMg, TAPER_MG),
+    TERM(pieceEg, TAPER_EG),
+    TERM(psqtMg, TAPER_MG),
+    TERM(psqtEg, TAPER_EG),
+    TERM(passedPawn, TAPER_NONE),
+    TERM(isolatedPawn, TAPER_NONE),
+    TERM(doubledPawn, TAPER_NONE),
+    TERM(backwardPawn, TAPER_NONE),
+    TERM(shieldNear, TAPER_NONE),
+    TERM(shieldFar, TAPER_NONE),
+    TERM(mobilityMg, TAPER_MG),
+    TERM(mobilityEg, TAPER_EG),
+    TERM(kingAttack, TAPER_MG),
+    TERM(hangingPiece, TAPER_NONE),
+    TERM(bishopPair, TAPER_NONE),
+    TERM(minorsForRook, TAPER_NONE),
+    TERM(rooksForQueen, TAPER_NONE)
+};
+
+const int EVAL_TERM_COUNT = sizeof(EVAL_TERMS) / sizeof(EVAL_TERMS[0]);
+
+int evalParamTaper(const int& index)
+{
+    for (int t = 0; t < EVAL_TERM_COUNT; t++)
+    {
+        if (index >= EVAL_TERMS[t].offset && index < EVAL_TERMS[t].offset + EVAL_TERMS[t].count)
+            return EVAL_TERMS[t].taper;
+    }
+
+    return TAPER_NONE;
+}
+
+EvalParams::EvalParams()
+{
+    for (int t = 0; t < 6; t++)
+    {
+        pieceMg[t] = PIECE_TYPE_VALUE[t];
+        pieceEg[t] = PIECE_TYPE_VALUE[t];
+
+        for (int sq = 0; sq < RANK * FILE; sq++)
+        {
+            psqtMg[t][sq] = PSQT_MG[t][sq];
+            psqtEg[t][sq] = PSQT_EG[t][sq];
+        }
+    }
+
+    for (int r = 0; r < RANK; r++)
+        passedPawn[r] = PASSED_PAWN_BONUS[r];
+
+    isolatedPawn = -ISOLATED_PAWN_PENALTY;
+    doubledPawn = -DOUBLED_PAWN_PENALTY;
+    backwardPawn = -BACKWARD_PAWN_PENALTY;
+
+    shieldNear = PAWN_SHIELD_BONUS;
+    shieldFar = PAWN_SHIELD_BONUS / 2;
+
+    for (int t = 0; t < 4; t++)
+    {
+        mobilityMg[t] = MOBILITY_MG[t];
+        mobilityEg[t] = MOBILITY_EG[t];
+        kingAttack[t] = KING_ATTACK_WEIGHT[t];
+    }
+    hangingPiece = -HANGING_PIECE_PENALTY;
+
+    bishopPair = BISHOP_PAIR_BONUS;
+    minorsForRook = MINORS_FOR_ROOK_BONUS;
+    rooksForQueen = -ROOKS_FOR_QUEEN_PENALTY;
+}
+
+bool EvalParams::load(const std::string& path)
+{
+    std::ifstream in(path.c_str());
+    std::string line;
+    EvalParams loaded = *this;
+
+    if (!in)
+        return false;
+
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+
+        if (!(fields >> name) || name.at(0) == '#')
+            continue;
+
+        int t = 0;
+        while (t < EVAL_TERM_COUNT && name != EVAL_TERMS[t].name)
+            t++;
+        if (t == EVAL_TERM_COUNT)
+            return false;
+
+        for (int i = 0; i < EVAL_TERMS[t].count; i++)
+        {
+            if (!(fields >> loaded.values()[EVAL_TERMS[t].offset + i]))
+                return false;
+        }
+    }
+
+    // Only take the file once all of it has been read
+    *this = loaded;
+
+    return true;
+}
+
+bool EvalParams::save(const std::string& path) const
+{
+    std::ofstream out(path.c_str());
+
+    for (int t = 0; t < EVAL_TERM_COUNT; t++)
+    {
+        out << EVAL_TERMS[t].name;
+        for (int i = 0; i < EVAL_TERMS[t].count; i++)
+            out << " " << values()[EVAL_TERMS[t].offset + i];
+        out << std::endl;
+    }
+
+    return (bool)out;
+}
+
+int attackTerms(const State& state, const AttackMaps& maps, EvalTrace* trace)
+{
+    int mg = 0, eg = 0, flat = 0;
+
+    for (int side = 0; side < 2; side++)
+    {
+        int sign = (side == 0) ? 1 : -1;
+        int enemy = 1 - side;
+        uint64_t safe = ~maps.occupied[side] & ~maps.pawns[enemy];
+
+        for (int i = 0; i < maps.count[side]; i++)
+        {
+            int t = maps.type[side][i] - 1;
+            int mobility = __builtin_popcountll(maps.attacks[side][i] & safe);
+            int kingAttacks = __builtin_popcountll(maps.attacks[side][i] & maps.kingZone[enemy]);
+
+            mg += sign * (mobility * evalParams.mobilityMg[t] + kingAttacks * evalParams.kingAttack[t]);
+            eg += sign * mobility * evalParams.mobilityEg[t];
+
+            if (trace)
+            {
+                trace->add(&evalParams.mobilityMg[t], side, mobility);
+                trace->add(&evalParams.mobilityEg[t], side, mobility);
+                trace->add(&evalParams.kingAttack[t], side, kingAttacks);
+            }
+        }
+
+        uint64_t pieces = maps.pieces[6 * side + 1] | maps.pieces[6 * side + 2] | maps.pieces[6 * side + 3] | maps.pieces[6 * side + 4];
+        int hanging = __builtin_popcountll(pieces & maps.all[enemy] & ~maps.all[side]);
+
+        flat += sign * hanging * evalParams.hangingPiece;
+        if (trace)
+            trace->add(&evalParams.hangingPiece, side, hanging);
+    }
+
+    int phase = std::min(state.getPhase(), MAX_PHASE);
+
+    return (mg * phase + eg * (MAX_PHASE - phase)) / MAX_PHASE + flat;
+}
+
+int expensiveTerms(const State& state, PawnTable& pawnTable, EvalTrace* trace)
+{
+    return pawnTable.evaluate(state, trace) + attackTerms(state, AttackMaps(state), trace);
+}
+
+int fullEvaluation(const State& state, PawnTable& pawnTable, MaterialTable& materialTable, EvalTrace* trace)
+{
+    if (trace)
+    {
+        trace->phase = std::min(state.getPhase(), MAX_PHASE);
+
+        for (int i = 1; i <= RANK; i++)
+        {
+            for (int j = 0; j < FILE; j++)
+            {
+                int piece = pieceIndex(state(i, j).letter);
+                if (piece == -1)
+                    continue;
+
+                int type = piece % 6;
+                int square = (piece < 6) ? squareIndex(i, j) : (squareIndex(i, j) ^ 56);
+                int side = (piece < 6) ? 0 : 1;
+
+                trace->add(&evalParams.pieceMg[type], side, 1);
+                trace->add(&evalParams.pieceEg[type], side, 1);
+                trace->add(&evalParams.psqtMg[type][square], side, 1);
+                trace->add(&evalParams.psqtEg[type][square], side, 1);
+            }
+        }
+    }
+
+    return state.stateHeuristic('w') + materialTable.imbalance(state, trace) + expensiveTerms(state, pawnTable, trace);
+}
+
+double tracedEvaluation(const EvalTrace& trace, const double* params)
+{
+    double mg = 0.0, eg = 0.0, flat = 0.0;
+
+    for (int t = 0; t < EVAL_TERM_COUNT; t++)
+    {
+        for (int i = EVAL_TERMS[t].offset; i < EVAL_TERMS[t].offset + EVAL_TERMS[t].count; i++)
+        {
+            if (trace.counts[i] == 0)
+                continue;
+
+            if (EVAL_TERMS[t].taper == TAPER_MG)
+                mg += trace.counts[i] * params[i];
+            else if (EVAL_TERMS[t].taper == TAPER_EG)
+                eg += trace.counts[i] * params[i];
+            else
+                flat += trace.counts[i] * params[i];
+        }
+    }
+
+    return (mg * trace.phase + eg * (MAX_PHASE - trace.phase)) / MAX_PHASE + flat;
+}
+
+}
+}
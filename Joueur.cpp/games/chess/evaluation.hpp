@@ -0,0 +1,113 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+// How a parameter is blended by game phase: middlegame weight only, endgame weight only, or the same throughout
+#define TAPER_MG 0
+#define TAPER_EG 1
+#define TAPER_NONE 2
+
+// Every tunable weight of the hand-written evaluation (in centipawns). Defaults come from psqt.hpp, pawn_table.hpp, attacks.hpp and material_table.hpp,
+// and eval_file=<path> replaces them with a file written by the tuner. The struct holds nothing but ints, so it
+// doubles as a flat array of EVAL_PARAM_COUNT parameters in declaration order.
+struct EvalParams
+{
+    int pieceMg[6];
+    int pieceEg[6];
+    int psqtMg[6][RANK * FILE];
+    int psqtEg[6][RANK * FILE];
+
+    int passedPawn[RANK];
+    int isolatedPawn;
+    int doubledPawn;
+    int backwardPawn;
+
+    // Own pawn one and two squares in front of a king still on its first two ranks
+    int shieldNear;
+    int shieldFar;
+
+    // Knights, bishops, rooks and queens: per square reached that holds no own piece and no enemy pawn attacks,
+    // and per square of the enemy king zone attacked; then per piece attacked but not defended
+    int mobilityMg[4];
+    int mobilityEg[4];
+    int kingAttack[4];
+    int hangingPiece;
+
+    // Both bishops, and two minors for a rook or two rooks for a queen (counted for the side with the more pieces)
+    int bishopPair;
+    int minorsForRook;
+    int rooksForQueen;
+
+    EvalParams();
+
+    // Read or write "name value value ..." lines, one per term of EVAL_TERMS
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    int* values() {return reinterpret_cast<int*>(this);}
+    const int* values() const {return reinterpret_cast<const int*>(this);}
+};
+
+#define EVAL_PARAM_COUNT ((int)(sizeof(EvalParams) / sizeof(int)))
+
+// First parameter past the piece values and piece-square tables, which all come before it
+#define EVAL_FEATURE_OFFSET ((int)(offsetof(EvalParams, passedPawn) / sizeof(int)))
+
+// A named group of consecutive parameters
+struct EvalTerm
+{
+    const char* name;
+    int offset;
+    int count;
+    int taper;
+};
+
+extern const EvalTerm EVAL_TERMS[];
+extern const int EVAL_TERM_COUNT;
+
+extern EvalParams evalParams;
+
+// Phase blend (TAPER_MG, TAPER_EG or TAPER_NONE) of the parameter at an index of EvalParams
+int evalParamTaper(const int& index);
+
+// Coefficient of every parameter in one position's evaluation (white's features count up, black's down),
+// so that the evaluation is the sum of coefficient * parameter, tapered by phase. Filled in for the tuner,
+// and for eval-trace, which also asks for black's share of each coefficient to show the two sides apart.
+struct EvalTrace
+{
+    int phase;
+    std::vector<int> counts;
+    std::vector<int> blackCounts;
+
+    EvalTrace(const bool& bySide = false) : phase(0), counts(EVAL_PARAM_COUNT, 0), blackCounts(bySide ? EVAL_PARAM_COUNT : 0, 0) {}
+
+    // Count a feature of one side (0 = white, 1 = black) count times
+    void add(const int* param, const int& side, const int& count)
+    {
+        int index = param - evalParams.values();
+        int signedCount = (side == 0) ? count : -count;
+
+        counts[index] += signedCount;
+        if (side == 1 && !blackCounts.empty())
+            blackCounts[index] += signedCount;
+
+        return;
+    }
+};
+
+class PawnTable;
+class MaterialTable;
+struct AttackMaps;
+
+// Mobility, king zone attacks and hanging pieces read off a position's attack maps (from white's point of view)
+int attackTerms(const State& state, const AttackMaps& maps, EvalTrace* trace);
+
+// Everything in the hand-written evaluation past material and piece-square tables (from white's point of view)
+int expensiveTerms(const State& state, PawnTable& pawnTable, EvalTrace* trace);
+
+// The whole hand-written evaluation (from white's point of view), optionally tracing its coefficients
+int fullEvaluation(const State& state, PawnTable& pawnTable, MaterialTable& materialTable, EvalTrace* trace);
+
+// Evaluation a trace adds up to with the given parameters, before rounding
+double tracedEvaluation(const EvalTrace& trace, const double* params);
+
+#endif
@@ -0,0 +1,102 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+// Count of a piece (by pieceIndex) in a material key
+static int keyCount(const uint64_t& materialKey, const int& piece)
+{
+    return (materialKey >> (MATERIAL_KEY_BITS * piece)) & ((1 << MATERIAL_KEY_BITS) - 1);
+}
+
+// Bishop pair and trades of unlike pieces for a material configuration (from white's point of view)
+static int imbalanceTerms(const uint64_t& materialKey, EvalTrace* trace)
+{
+    int minors[2], rooks[2], queens[2];
+    int score = 0;
+
+    for (int side = 0; side < 2; side++)
+    {
+        int sign = (side == 0) ? 1 : -1;
+        int base = 6 * side;
+
+        minors[side] = keyCount(materialKey, base + 1) + keyCount(materialKey, base + 2);
+        rooks[side] = keyCount(materialKey, base + 3);
+        queens[side] = keyCount(materialKey, base + 4);
+
+        if (keyCount(materialKey, base + 2) >= 2)
+        {
+            score += sign * evalParams.bishopPair;
+            if (trace)
+                trace->add(&evalParams.bishopPair, side, 1);
+        }
+    }
+
+    // Only the plain trades: two minors for a rook, two rooks for a queen, with the rest of the pieces even.
+    // Each counts for the side with the more pieces.
+    for (int side = 0; side < 2; side++)
+    {
+        int sign = (side == 0) ? 1 : -1;
+        int enemy = 1 - side;
+
+        if (minors[side] - minors[enemy] == 2 && rooks[enemy] - rooks[side] == 1 && queens[side] == queens[enemy])
+        {
+            score += sign * evalParams.minorsForRook;
+            if (trace)
+                trace->add(&evalParams.minorsForRook, side, 1);
+        }
+
+        if (rooks[side] - rooks[enemy] == 2 && queens[enemy] - queens[side] == 1 && minors[side] == minors[enemy])
+        {
+            score += sign * evalParams.rooksForQueen;
+            if (trace)
+                trace->add(&evalParams.rooksForQueen, side, 1);
+        }
+    }
+
+    return score;
+}
+
+MaterialTable::MaterialTable() : table(MATERIAL_TABLE_SIZE)
+{
+    // No position has every count at fifteen, so that key marks the empty slots
+    for (unsigned int i = 0; i < table.size(); i++)
+        table.at(i).key = ~0ULL;
+
+    probes = 0;
+    hits = 0;
+}
+
+const MaterialEntry& MaterialTable::probe(const State& state)
+{
+    uint64_t key = state.getMaterialKey();
+
+    // Counts are small numbers spread across the key, so multiply them all into the top bits and take those
+    MaterialEntry& entry = table[(key * 0x9E3779B97F4A7C15ULL) >> 52];
+
+    probes++;
+    if (entry.key == key)
+    {
+        hits++;
+        return entry;
+    }
+
+    entry.key = key;
+    entry.imbalance = imbalanceTerms(key, NULL);
+    entry.endgame = endgames.probe(key);
+
+    return entry;
+}
+
+int MaterialTable::imbalance(const State& state, EvalTrace* trace)
+{
+    if (trace)
+        return imbalanceTerms(state.getMaterialKey(), trace);
+
+    return probe(state).imbalance;
+}
+
+}
+}
@@ -0,0 +1,47 @@
+#ifndef MATERIAL_TABLE_HPP
+#define MATERIAL_TABLE_HPP
+
+// Number of entries in each search thread's material table (the probe takes the top 12 bits of a hash)
+#define MATERIAL_TABLE_SIZE 4096
+
+// Default material imbalance weights (in centipawns), the starting point of the tunable evalParams
+#define BISHOP_PAIR_BONUS 30
+
+// Two minor pieces against a rook, and two rooks against a queen (for the side with the more pieces)
+#define MINORS_FOR_ROOK_BONUS 10
+#define ROOKS_FOR_QUEEN_PENALTY 20
+
+// What a material configuration contributes to the evaluation. Both parts depend on nothing but the material key.
+struct MaterialEntry
+{
+    uint64_t key;
+
+    // Bishop pair and trades of unlike pieces (in centipawns, from white's point of view)
+    int imbalance;
+
+    // Endgame knowledge for the configuration, NULL for most
+    const EndgameEntry* endgame;
+};
+
+// Small direct-mapped table of material configurations keyed by the material key, filled on first use. Each
+// search thread owns one. Material changes only on captures and promotions, so nearly every probe is a hit.
+class MaterialTable
+{
+    private:
+        std::vector<MaterialEntry> table;
+
+    public:
+        uint64_t probes;
+        uint64_t hits;
+
+        MaterialTable();
+
+        // Entry for the material of a state, analysed on a miss
+        const MaterialEntry& probe(const State& state);
+
+        // Imbalance score of a state (from white's point of view). A traced evaluation bypasses the table and
+        // records the coefficient of every term.
+        int imbalance(const State& state, EvalTrace* trace);
+};
+
+#endif
@@ -0,0 +1,204 @@
+// Included ahead of ai.hpp, whose FILE macro would break the C stdio declarations they pull in
+#include <fstream>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+Network network;
+
+const char* nnueKernels()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE4_1__)
+    return "SSE4.1";
+#else
+    return "scalar";
+#endif
+}
+
+// Input feature of a piece on a square as seen from one side: own pieces first, squares mirrored for black
+static int featureIndex(const int& perspective, const int& piece, const int& square)
+{
+    bool own = ((piece < 6) == (perspective == 0));
+    int type = piece % 6;
+
+    return ((own ? 0 : 6) + type) * RANK * FILE + ((perspective == 0) ? square : (square ^ 56));
+}
+
+// accumulator += row (or -= row) over NNUE_HIDDEN entries
+static void addRow(int16_t* accumulator, const int16_t* row, const int& sign)
+{
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(accumulator + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(row + i));
+        a = (sign > 0) ? _mm256_add_epi16(a, w) : _mm256_sub_epi16(a, w);
+        _mm256_storeu_si256((__m256i*)(accumulator + i), a);
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(accumulator + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(row + i));
+        a = (sign > 0) ? _mm_add_epi16(a, w) : _mm_sub_epi16(a, w);
+        _mm_storeu_si128((__m128i*)(accumulator + i), a);
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+        accumulator[i] += (sign > 0) ? row[i] : -row[i];
+#endif
+
+    return;
+}
+
+// Clip an accumulator to [0, NNUE_CLIP] as unsigned bytes
+static void clipAccumulator(const int16_t* accumulator, uint8_t* output)
+{
+#if defined(__AVX2__)
+    const __m256i clip = _mm256_set1_epi16(NNUE_CLIP);
+    for (int i = 0; i < NNUE_HIDDEN; i += 32)
+    {
+        __m256i a = _mm256_min_epi16(_mm256_loadu_si256((const __m256i*)(accumulator + i)), clip);
+        __m256i b = _mm256_min_epi16(_mm256_loadu_si256((const __m256i*)(accumulator + i + 16)), clip);
+
+        // packus saturates negatives to 0 but interleaves the 128-bit lanes, so put them back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)(output + i), packed);
+    }
+#elif defined(__SSE4_1__)
+    const __m128i clip = _mm_set1_epi16(NNUE_CLIP);
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        __m128i a = _mm_min_epi16(_mm_loadu_si128((const __m128i*)(accumulator + i)), clip);
+        __m128i b = _mm_min_epi16(_mm_loadu_si128((const __m128i*)(accumulator + i + 8)), clip);
+        _mm_storeu_si128((__m128i*)(output + i), _mm_packus_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+        output[i] = (uint8_t)std::max(0, std::min((int)accumulator[i], NNUE_CLIP));
+#endif
+
+    return;
+}
+
+// Dot product of clipped inputs with a row of int8 weights over 2 * NNUE_HIDDEN entries
+static int32_t dotRow(const uint8_t* input, const int8_t* row)
+{
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < 2 * NNUE_HIDDEN; i += 32)
+    {
+        // Products of adjacent byte pairs summed to 16 bits (at most 2 * 127 * 128, so they never saturate), then to 32
+        __m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(input + i)), _mm256_loadu_si256((const __m256i*)(row + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+#elif defined(__SSE4_1__)
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < 2 * NNUE_HIDDEN; i += 16)
+    {
+        __m128i products = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i*)(input + i)), _mm_loadu_si128((const __m128i*)(row + i)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < 2 * NNUE_HIDDEN; i++)
+        sum += input[i] * row[i];
+    return sum;
+#endif
+}
+
+template <typename T>
+static bool readArray(std::ifstream& in, std::vector<T>& values, const int& count)
+{
+    values.resize(count);
+    in.read((char*)values.data(), count * sizeof(T));
+
+    return (bool)in;
+}
+
+Network::Network()
+{
+    outputBias = 0;
+    loaded = false;
+}
+
+bool Network::load(const std::string& path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    uint32_t magic = 0;
+
+    loaded = false;
+    if (!in.read((char*)&magic, sizeof(magic)) || magic != NNUE_MAGIC)
+        return false;
+
+    if (!readArray(in, l1Weights, NNUE_INPUTS * NNUE_HIDDEN) || !readArray(in, l1Biases, NNUE_HIDDEN)
+        || !readArray(in, l2Weights, NNUE_L2 * 2 * NNUE_HIDDEN) || !readArray(in, l2Biases, NNUE_L2)
+        || !readArray(in, outputWeights, NNUE_L2) || !in.read((char*)&outputBias, sizeof(outputBias)))
+        return false;
+
+    // Anything left over means the file is for a different shape
+    if (in.peek() != std::char_traits<char>::eof())
+        return false;
+
+    loaded = true;
+
+    return true;
+}
+
+void Network::reset(Accumulator& accumulator) const
+{
+    for (int p = 0; p < 2; p++)
+        std::copy(l1Biases.begin(), l1Biases.end(), accumulator.values[p]);
+
+    return;
+}
+
+void Network::update(Accumulator& accumulator, const int& piece, const int& square, const int& sign) const
+{
+    for (int p = 0; p < 2; p++)
+        addRow(accumulator.values[p], &l1Weights[featureIndex(p, piece, square) * NNUE_HIDDEN], sign);
+
+    return;
+}
+
+int Network::evaluate(const Accumulator& accumulator, const char& sideToMove) const
+{
+    uint8_t input[2 * NNUE_HIDDEN];
+    int us = (sideToMove == 'w') ? 0 : 1;
+
+    clipAccumulator(accumulator.values[us], input);
+    clipAccumulator(accumulator.values[1 - us], input + NNUE_HIDDEN);
+
+    int32_t output = outputBias;
+    for (int i = 0; i < NNUE_L2; i++)
+    {
+        int32_t hidden = dotRow(input, &l2Weights[i * 2 * NNUE_HIDDEN]) + l2Biases[i];
+        hidden = (hidden < 0) ? 0 : std::min(hidden >> NNUE_L2_SHIFT, (int32_t)NNUE_CLIP);
+        output += hidden * outputWeights[i];
+    }
+
+    return output / NNUE_OUTPUT_SCALE;
+}
+
+}
+}
@@ -0,0 +1,102 @@
+#ifndef NNUE_HPP
+#define NNUE_HPP
+
+// Network shape: 768 piece-square inputs (own and enemy pieces, 6 types, 64 squares) into a 256 wide accumulator
+// per perspective, both accumulators (side to move first) into 32 hidden units, and those into a single output
+#define NNUE_INPUTS 768
+#define NNUE_HIDDEN 256
+#define NNUE_L2 32
+
+// Quantisation: accumulators are clipped to [0, NNUE_CLIP] before the second layer, whose sums are shifted right
+// by NNUE_L2_SHIFT and clipped again. The output divided by NNUE_OUTPUT_SCALE is in centipawns.
+#define NNUE_CLIP 127
+#define NNUE_L2_SHIFT 6
+#define NNUE_OUTPUT_SCALE 16
+
+// First four bytes of a weights file ("NNUE" read little-endian)
+#define NNUE_MAGIC 0x45554E4E
+
+// First layer output for each perspective (0 = white, 1 = black), updated by State as pieces come and go
+struct Accumulator
+{
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+// An Accumulator kept out of line, so that every State (copied for every child in the search) only carries a
+// pointer. It stays empty until a network is loaded; copies are deep.
+class AccumulatorPtr
+{
+    private:
+        std::unique_ptr<Accumulator> accumulator;
+
+    public:
+        AccumulatorPtr() {}
+        AccumulatorPtr(const AccumulatorPtr& other) : accumulator(other.accumulator ? new Accumulator(*other.accumulator) : NULL) {}
+        AccumulatorPtr(AccumulatorPtr&& other) = default;
+
+        AccumulatorPtr& operator=(const AccumulatorPtr& other)
+        {
+            if (!other.accumulator)
+                accumulator.reset();
+            else if (accumulator)
+                *accumulator = *other.accumulator;
+            else
+                accumulator.reset(new Accumulator(*other.accumulator));
+
+            return *this;
+        }
+        AccumulatorPtr& operator=(AccumulatorPtr&& other) = default;
+
+        // The accumulator, allocated on first use
+        Accumulator& create()
+        {
+            if (!accumulator)
+                accumulator.reset(new Accumulator());
+
+            return *accumulator;
+        }
+
+        explicit operator bool() const {return (bool)accumulator;}
+        Accumulator& operator*() const {return *accumulator;}
+};
+
+// Efficiently updatable network, an alternative to stateHeuristic selected with nnue=<weights file>.
+// A weights file is the magic number followed by, little-endian and row by row:
+//   int16 first layer weights [NNUE_INPUTS][NNUE_HIDDEN], int16 first layer biases [NNUE_HIDDEN],
+//   int8 second layer weights [NNUE_L2][2 * NNUE_HIDDEN], int32 second layer biases [NNUE_L2],
+//   int8 output weights [NNUE_L2], int32 output bias.
+// The kernels use AVX2 or SSE4.1 when the compiler targets them, and plain loops otherwise.
+class Network
+{
+    private:
+        std::vector<int16_t> l1Weights;
+        std::vector<int16_t> l1Biases;
+        std::vector<int8_t> l2Weights;
+        std::vector<int32_t> l2Biases;
+        std::vector<int8_t> outputWeights;
+        int32_t outputBias;
+        bool loaded;
+
+    public:
+        Network();
+
+        // Read a weights file, leaving the network unloaded if anything about it is wrong
+        bool load(const std::string& path);
+        bool isLoaded() const {return loaded;}
+
+        // Accumulator of an empty board
+        void reset(Accumulator& accumulator) const;
+
+        // Add (sign 1) or remove (sign -1) a piece (pieceIndex) on a square (squareIndex) in both perspectives
+        void update(Accumulator& accumulator, const int& piece, const int& square, const int& sign) const;
+
+        // Score in centipawns for the side to move ('w' or 'b')
+        int evaluate(const Accumulator& accumulator, const char& sideToMove) const;
+};
+
+extern Network network;
+
+// Instruction set the kernels were compiled for
+const char* nnueKernels();
+
+#endif
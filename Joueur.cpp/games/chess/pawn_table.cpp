@@ -0,0 +1,181 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+static const uint64_t FILE_A_MASK = 0x0101010101010101ULL;
+
+static uint64_t fileMask(const int& file) {return FILE_A_MASK << file;}
+static uint64_t adjacentFiles(const int& file) {return ((file > 0) ? fileMask(file - 1) : 0) | ((file < FILE - 1) ? fileMask(file + 1) : 0);}
+
+// Every square on the ranks in front of the given rank, as seen by the given side
+static uint64_t forwardRanks(const int& rank, const int& side)
+{
+    if (side == 0)
+        return (rank >= RANK) ? 0 : (~0ULL << (rank * FILE));
+
+    return (1ULL << ((rank - 1) * FILE)) - 1;
+}
+
+// Shelter of own pawns in front of a king still on its first two ranks
+static int pawnShield(const uint64_t& pawns, const int& kingRank, const int& kingFile, const int& side, EvalTrace* trace)
+{
+    int direction = (side == 0) ? 1 : -1;
+    int relativeRank = (side == 0) ? kingRank : RANK + 1 - kingRank;
+    int score = 0;
+
+    if (relativeRank > 2)
+        return 0;
+
+    for (int f = std::max(0, kingFile - 1); f <= std::min(FILE - 1, kingFile + 1); f++)
+    {
+        if (pawns & (1ULL << squareIndex(kingRank + direction, f)))
+        {
+            score += evalParams.shieldNear;
+            if (trace)
+                trace->add(&evalParams.shieldNear, side, 1);
+        }
+        else if (pawns & (1ULL << squareIndex(kingRank + 2 * direction, f)))
+        {
+            score += evalParams.shieldFar;
+            if (trace)
+                trace->add(&evalParams.shieldFar, side, 1);
+        }
+    }
+
+    return score;
+}
+
+PawnTable::PawnTable() : table(PAWN_TABLE_SIZE)
+{
+    // An all-zero key belongs to positions without pawns, so mark the empty slots with a key no position has
+    for (unsigned int i = 0; i < table.size(); i++)
+        table.at(i).key = ~0ULL;
+
+    probes = 0;
+    hits = 0;
+}
+
+const PawnEntry& PawnTable::probe(const State& state)
+{
+    uint64_t key = state.getPawnKey();
+    PawnEntry& entry = table[key & (PAWN_TABLE_SIZE - 1)];
+
+    probes++;
+    if (entry.key == key)
+    {
+        hits++;
+        return entry;
+    }
+
+    entry.key = key;
+    analyse(state, entry, NULL);
+
+    return entry;
+}
+
+void PawnTable::analyse(const State& state, PawnEntry& entry, EvalTrace* trace) const
+{
+    entry.pawns[0] = state.pawnBitboard('w');
+    entry.pawns[1] = state.pawnBitboard('b');
+    entry.score = 0;
+    entry.openFiles = 0;
+
+    for (int side = 0; side < 2; side++)
+    {
+        uint64_t own = entry.pawns[side];
+        uint64_t enemy = entry.pawns[1 - side];
+        uint64_t enemyAttacks = pawnAttacks(enemy, 1 - side);
+        int score = 0;
+        int sign = (side == 0) ? 1 : -1;
+
+        entry.passed[side] = 0;
+        entry.attackSpans[side] = 0;
+        entry.semiOpenFiles[side] = 0;
+
+        for (int f = 0; f < FILE; f++)
+        {
+            if (!(own & fileMask(f)))
+                entry.semiOpenFiles[side] |= 1 << f;
+        }
+
+        for (uint64_t remaining = own; remaining; remaining &= remaining - 1)
+        {
+            int square = __builtin_ctzll(remaining);
+            int rank = square / FILE + 1;
+            int file = square % FILE;
+            uint64_t front = forwardRanks(rank, side);
+            uint64_t frontSpan = front & fileMask(file);
+            uint64_t attackSpan = front & adjacentFiles(file);
+
+            entry.attackSpans[side] |= attackSpan;
+
+            // Passed: nothing can block or capture it on its way
+            if (!(enemy & (frontSpan | attackSpan)))
+            {
+                const int* bonus = &evalParams.passedPawn[(side == 0) ? rank - 1 : RANK - rank];
+
+                entry.passed[side] |= 1ULL << square;
+                score += *bonus;
+                if (trace)
+                    trace->add(bonus, side, 1);
+            }
+
+            // Doubled: penalise the pawn behind
+            if (own & frontSpan)
+            {
+                score += evalParams.doubledPawn;
+                if (trace)
+                    trace->add(&evalParams.doubledPawn, side, 1);
+            }
+
+            // Isolated: no pawn on a neighbouring file; backward: every neighbour is ahead and the stop square is guarded
+            if (!(own & adjacentFiles(file)))
+            {
+                score += evalParams.isolatedPawn;
+                if (trace)
+                    trace->add(&evalParams.isolatedPawn, side, 1);
+            }
+            else if (!(own & adjacentFiles(file) & ~front))
+            {
+                int stop = square + ((side == 0) ? FILE : -FILE);
+                if (stop >= 0 && stop < RANK * FILE && (enemyAttacks & (1ULL << stop)))
+                {
+                    score += evalParams.backwardPawn;
+                    if (trace)
+                        trace->add(&evalParams.backwardPawn, side, 1);
+                }
+            }
+        }
+
+        entry.score += sign * score;
+    }
+
+    entry.openFiles = entry.semiOpenFiles[0] & entry.semiOpenFiles[1];
+
+    return;
+}
+
+int PawnTable::evaluate(const State& state, EvalTrace* trace)
+{
+    PawnEntry traced;
+
+    // A traced evaluation analyses the pawns itself so that every term gets counted
+    if (trace)
+        analyse(state, traced, trace);
+    const PawnEntry& entry = trace ? traced : probe(state);
+
+    // King shelter depends on where the kings are, so it is added on top of the cached structure
+    bool white = (state.getPlayerColor() == 'w');
+    int whiteKingRank = white ? state.getMyKingRank() : state.getOppKingRank();
+    int blackKingRank = white ? state.getOppKingRank() : state.getMyKingRank();
+    int whiteKingFile = state.convertFile(white ? state.getMyKingFile() : state.getOppKingFile());
+    int blackKingFile = state.convertFile(white ? state.getOppKingFile() : state.getMyKingFile());
+
+    return entry.score + pawnShield(entry.pawns[0], whiteKingRank, whiteKingFile, 0, trace) - pawnShield(entry.pawns[1], blackKingRank, blackKingFile, 1, trace);
+}
+
+}
+}
@@ -0,0 +1,60 @@
+#ifndef PAWN_TABLE_HPP
+#define PAWN_TABLE_HPP
+
+// Number of entries in each search thread's pawn table
+#define PAWN_TABLE_SIZE 16384
+
+// Default pawn structure weights (in centipawns), the starting point of the tunable evalParams
+#define ISOLATED_PAWN_PENALTY 15
+#define DOUBLED_PAWN_PENALTY 10
+#define BACKWARD_PAWN_PENALTY 8
+
+// Own pawn directly in front of a king still on its first two ranks, half for one two squares in front
+#define PAWN_SHIELD_BONUS 10
+
+// Bonus for a passed pawn by rank, counted from its own side of the board
+const int PASSED_PAWN_BONUS[RANK] = {0, 10, 15, 25, 40, 65, 100, 0};
+
+// Pawn structure of a position. Bitboards use bit squareIndex(rank, file); index 0 is white, 1 is black.
+struct PawnEntry
+{
+    uint64_t key;
+
+    // Passed, isolated, doubled and backward pawns (in centipawns, from white's point of view)
+    int score;
+
+    uint64_t pawns[2];
+    uint64_t passed[2];
+
+    // Squares the pawns of a side attack or may attack as they advance
+    uint64_t attackSpans[2];
+
+    // Files without a pawn of a side, and without any pawn (bit = file index)
+    uint8_t semiOpenFiles[2];
+    uint8_t openFiles;
+};
+
+// Small direct-mapped table of pawn structures keyed by the pawn Zobrist key. Each search thread owns one,
+// so entries don't need to be atomic. Pawns rarely move, so nearly every probe is a hit.
+class PawnTable
+{
+    private:
+        std::vector<PawnEntry> table;
+
+        void analyse(const State& state, PawnEntry& entry, EvalTrace* trace) const;
+
+    public:
+        uint64_t probes;
+        uint64_t hits;
+
+        PawnTable();
+
+        // Entry for the pawns of a state, analysed on a miss
+        const PawnEntry& probe(const State& state);
+
+        // Pawn structure and king shelter score of a state (from white's point of view). A traced evaluation
+        // bypasses the table and records the coefficient of every term.
+        int evaluate(const State& state, EvalTrace* trace);
+};
+
+#endif
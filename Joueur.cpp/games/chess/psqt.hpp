@@ -0,0 +1,130 @@
+#ifndef PSQT_HPP
+#define PSQT_HPP
+
+// Game phase: knights and bishops count 1, rooks 2 and queens 4, for a total of 24 with every piece on the board.
+// Evaluation blends the middlegame and endgame scores by phase / MAX_PHASE.
+#define MAX_PHASE 24
+const int PHASE_WEIGHT[6] = {0, 1, 1, 2, 4, 0};
+
+// Material by piece type (P N B R Q K). Also the default middlegame and endgame piece values of evalParams.
+const int PIECE_TYPE_VALUE[6] = {PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE, ROOK_VALUE, QUEEN_VALUE, 0};
+
+// Default piece-square bonuses (in centipawns) for white by piece type, indexed by squareIndex: a1 first, rank by rank.
+// Black looks them up with the rank mirrored (squareIndex ^ 56). The evaluation reads the tunable copies in evalParams.
+const int PSQT_MG[6][RANK * FILE] =
+{
+    // Pawn
+    {  0,   0,   0,   0,   0,   0,   0,   0,
+       5,  10,  10, -20, -20,  10,  10,   5,
+       5,  -5, -10,   0,   0, -10,  -5,   5,
+       0,   0,   0,  20,  20,   0,   0,   0,
+       5,   5,  10,  25,  25,  10,   5,   5,
+      10,  10,  20,  30,  30,  20,  10,  10,
+      50,  50,  50,  50,  50,  50,  50,  50,
+       0,   0,   0,   0,   0,   0,   0,   0},
+    // Knight
+    {-50, -40, -30, -30, -30, -30, -40, -50,
+     -40, -20,   0,   5,   5,   0, -20, -40,
+     -30,   5,  10,  15,  15,  10,   5, -30,
+     -30,   0,  15,  20,  20,  15,   0, -30,
+     -30,   5,  15,  20,  20,  15,   5, -30,
+     -30,   0,  10,  15,  15,  10,   0, -30,
+     -40, -20,   0,   0,   0,   0, -20, -40,
+     -50, -40, -30, -30, -30, -30, -40, -50},
+    // Bishop
+    {-20, -10, -10, -10, -10, -10, -10, -20,
+     -10,   5,   0,   0,   0,   0,   5, -10,
+     -10,  10,  10,  10,  10,  10,  10, -10,
+     -10,   0,  10,  10,  10,  10,   0, -10,
+     -10,   5,   5,  10,  10,   5,   5, -10,
+     -10,   0,   5,  10,  10,   5,   0, -10,
+     -10,   0,   0,   0,   0,   0,   0, -10,
+     -20, -10, -10, -10, -10, -10, -10, -20},
+    // Rook
+    {  0,   0,   0,   5,   5,   0,   0,   0,
+      -5,   0,   0,   0,   0,   0,   0,  -5,
+      -5,   0,   0,   0,   0,   0,   0,  -5,
+      -5,   0,   0,   0,   0,   0,   0,  -5,
+      -5,   0,   0,   0,   0,   0,   0,  -5,
+      -5,   0,   0,   0,   0,   0,   0,  -5,
+       5,  10,  10,  10,  10,  10,  10,   5,
+       0,   0,   0,   0,   0,   0,   0,   0},
+    // Queen
+    {-20, -10, -10,  -5,  -5, -10, -10, -20,
+     -10,   0,   5,   0,   0,   0,   0, -10,
+     -10,   5,   5,   5,   5,   5,   0, -10,
+       0,   0,   5,   5,   5,   5,   0,  -5,
+      -5,   0,   5,   5,   5,   5,   0,  -5,
+     -10,   0,   5,   5,   5,   5,   0, -10,
+     -10,   0,   0,   0,   0,   0,   0, -10,
+     -20, -10, -10,  -5,  -5, -10, -10, -20},
+    // King: tucked away behind its pawns
+    { 20,  30,  10,   0,   0,  10,  30,  20,
+      20,  20,   0,   0,   0,   0,  20,  20,
+     -10, -20, -20, -20, -20, -20, -20, -10,
+     -20, -30, -30, -40, -40, -30, -30, -20,
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -30, -40, -40, -50, -50, -40, -40, -30}
+};
+
+const int PSQT_EG[6][RANK * FILE] =
+{
+    // Pawn: worth more the further it has advanced
+    {  0,   0,   0,   0,   0,   0,   0,   0,
+       0,   0,   0,   0,   0,   0,   0,   0,
+       5,   5,   5,   5,   5,   5,   5,   5,
+      10,  10,  10,  10,  10,  10,  10,  10,
+      15,  15,  15,  15,  15,  15,  15,  15,
+      25,  25,  25,  25,  25,  25,  25,  25,
+      40,  40,  40,  40,  40,  40,  40,  40,
+       0,   0,   0,   0,   0,   0,   0,   0},
+    // Knight
+    {-50, -40, -30, -30, -30, -30, -40, -50,
+     -40, -20,   0,   0,   0,   0, -20, -40,
+     -30,   0,  10,  15,  15,  10,   0, -30,
+     -30,   5,  15,  20,  20,  15,   5, -30,
+     -30,   5,  15,  20,  20,  15,   5, -30,
+     -30,   0,  10,  15,  15,  10,   0, -30,
+     -40, -20,   0,   0,   0,   0, -20, -40,
+     -50, -40, -30, -30, -30, -30, -40, -50},
+    // Bishop
+    {-20, -10, -10, -10, -10, -10, -10, -20,
+     -10,   0,   0,   0,   0,   0,   0, -10,
+     -10,   0,   5,  10,  10,   5,   0, -10,
+     -10,   5,  10,  10,  10,  10,   5, -10,
+     -10,   5,  10,  10,  10,  10,   5, -10,
+     -10,   0,   5,  10,  10,   5,   0, -10,
+     -10,   0,   0,   0,   0,   0,   0, -10,
+     -20, -10, -10, -10, -10, -10, -10, -20},
+    // Rook
+    {  0,   0,   0,   0,   0,   0,   0,   0,
+       0,   0,   0,   0,   0,   0,   0,   0,
+       0,   0,   0,   0,   0,   0,   0,   0,
+       0,   0,   0,   0,   0,   0,   0,   0,
+       0,   0,   0,   0,   0,   0,   0,   0,
+       0,   0,   0,   0,   0,   0,   0,   0,
+      10,  10,  10,  10,  10,  10,  10,  10,
+       0,   0,   0,   0,   0,   0,   0,   0},
+    // Queen
+    {-20, -10, -10,  -5,  -5, -10, -10, -20,
+     -10,   0,   0,   0,   0,   0,   0, -10,
+     -10,   0,   5,   5,   5,   5,   0, -10,
+      -5,   0,   5,  10,  10,   5,   0,  -5,
+      -5,   0,   5,  10,  10,   5,   0,  -5,
+     -10,   0,   5,   5,   5,   5,   0, -10,
+     -10,   0,   0,   0,   0,   0,   0, -10,
+     -20, -10, -10,  -5,  -5, -10, -10, -20},
+    // King: heads for the centre once the heavy pieces are gone
+    {-50, -30, -30, -30, -30, -30, -30, -50,
+     -30, -30,   0,   0,   0,   0, -30, -30,
+     -30, -10,  20,  30,  30,  20, -10, -30,
+     -30, -10,  30,  40,  40,  30, -10, -30,
+     -30, -10,  30,  40,  40,  30, -10, -30,
+     -30, -10,  20,  30,  30,  20, -10, -30,
+     -30, -20, -10,   0,   0, -10, -20, -30,
+     -50, -40, -30, -20, -20, -30, -40, -50}
+};
+
+#endif
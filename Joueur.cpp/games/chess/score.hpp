@@ -0,0 +1,47 @@
+#ifndef SCORE_HPP
+#define SCORE_HPP
+
+// Scores are in centipawns from the root player's point of view. A mate delivered n plies from the root
+// scores MATE - n (and -(MATE - n) when the root player is the one mated), so a shorter mate is preferred.
+#define MATE 32000
+#define INFINITE_SCORE (MATE + 1)
+
+// Every score at least this far from zero is a mate within MAX_PLY
+#define MATE_BOUND (MATE - MAX_PLY)
+
+inline bool isMateScore(const int& score) {return score >= MATE_BOUND || score <= -MATE_BOUND;}
+
+// The transposition table keeps mate scores relative to the node they were found at rather than the root,
+// so they stay correct when the position is reached again at a different ply
+inline int scoreToTT(const int& score, const int& ply)
+{
+    if (score >= MATE_BOUND)
+        return score + ply;
+    if (score <= -MATE_BOUND)
+        return score - ply;
+
+    return score;
+}
+
+inline int scoreFromTT(const int& score, const int& ply)
+{
+    if (score >= MATE_BOUND)
+        return score - ply;
+    if (score <= -MATE_BOUND)
+        return score + ply;
+
+    return score;
+}
+
+// "mate N" in moves (negative when being mated) or "cp N"
+inline std::string scoreString(const int& score)
+{
+    if (score >= MATE_BOUND)
+        return "mate " + std::to_string((MATE - score + 1) / 2);
+    if (score <= -MATE_BOUND)
+        return "mate -" + std::to_string((MATE + score + 1) / 2);
+
+    return "cp " + std::to_string(score);
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef SEARCH_PARAMS_HPP
+#define SEARCH_PARAMS_HPP
+
+// Null move: depth reduction (one more from depth 6) and the non-pawn material (in centipawns)
+// at or below which a null move cutoff is verified by a reduced normal search
+#define DEFAULT_NULL_MOVE_REDUCTION 2
+#define DEFAULT_NULL_MOVE_VERIFY 500
+
+// Reverse futility: margin per ply of depth and the deepest node it applies to
+#define DEFAULT_RFP_MARGIN 120
+#define DEFAULT_RFP_DEPTH 3
+
+// Futility: margin per ply of depth and the deepest node it applies to
+#define DEFAULT_FUTILITY_MARGIN 200
+#define DEFAULT_FUTILITY_DEPTH 1
+
+// Razoring: margin per ply of depth and the deepest node it applies to
+#define DEFAULT_RAZOR_MARGIN 300
+#define DEFAULT_RAZOR_DEPTH 2
+
+// Late move reductions: reduction = base + ln(depth) * ln(move number) / divisor (both in hundredths),
+// applied to quiet moves from LMR_MIN_MOVE on at nodes of at least LMR_MIN_DEPTH
+#define DEFAULT_LMR_BASE 75
+#define DEFAULT_LMR_DIVISOR 225
+#define LMR_MIN_DEPTH 3
+#define LMR_MIN_MOVE 3
+#define LMR_TABLE_SIZE 64
+
+// Extensions (in plies) for moves that give check and for passed pawns pushed to the seventh rank
+#define DEFAULT_CHECK_EXTENSION 1
+#define DEFAULT_PAWN_EXTENSION 1
+
+// Aspiration windows: half-width (in centipawns) of the first window around the last iteration's score,
+// the first iteration to use one, and the width past which a failing side is opened up completely
+#define DEFAULT_ASPIRATION_WINDOW 50
+#define ASPIRATION_MIN_DEPTH 3
+#define ASPIRATION_MAX_WINDOW 1000
+
+// Number of best root moves searched with exact scores and reported each iteration
+#define DEFAULT_MULTI_PV 1
+
+// Quiescence search: deepest capture sequence played out past the horizon, and the margin (in centipawns)
+// on top of a captured piece's value below which a capture is assumed not to matter
+#define DEFAULT_QS_MAX_PLY 8
+#define DEFAULT_DELTA_MARGIN 200
+
+// Lazy evaluation: margin (in centipawns) outside the window past which material and piece-square tables alone
+// are trusted, and how often (one lazy exit in this many) the full evaluation is worked out anyway to check it
+#define DEFAULT_LAZY_MARGIN 200
+#define LAZY_CHECK_INTERVAL 16
+
+// Pruning, reduction and extension switches and margins, each overridable through --aiSettings
+struct SearchParams
+{
+    bool nullMove;
+    int nullMoveReduction;
+    int nullMoveVerify;
+
+    bool rfp;
+    int rfpMargin;
+    int rfpDepth;
+
+    bool futility;
+    int futilityMargin;
+    int futilityDepth;
+
+    bool razoring;
+    int razorMargin;
+    int razorDepth;
+
+    bool lmr;
+    int lmrBase;
+    int lmrDivisor;
+    int reductions[LMR_TABLE_SIZE][LMR_TABLE_SIZE];
+
+    int checkExtension;
+    int pawnExtension;
+
+    int aspirationWindow;
+    int multiPv;
+
+    int qsMaxPly;
+    int deltaMargin;
+
+    int lazyMargin;
+
+    SearchParams()
+    {
+        nullMove = true;
+        nullMoveReduction = DEFAULT_NULL_MOVE_REDUCTION;
+        nullMoveVerify = DEFAULT_NULL_MOVE_VERIFY;
+
+        rfp = true;
+        rfpMargin = DEFAULT_RFP_MARGIN;
+        rfpDepth = DEFAULT_RFP_DEPTH;
+
+        futility = true;
+        futilityMargin = DEFAULT_FUTILITY_MARGIN;
+        futilityDepth = DEFAULT_FUTILITY_DEPTH;
+
+        razoring = true;
+        razorMargin = DEFAULT_RAZOR_MARGIN;
+        razorDepth = DEFAULT_RAZOR_DEPTH;
+
+        lmr = true;
+        lmrBase = DEFAULT_LMR_BASE;
+        lmrDivisor = DEFAULT_LMR_DIVISOR;
+        initReductions();
+
+        checkExtension = DEFAULT_CHECK_EXTENSION;
+        pawnExtension = DEFAULT_PAWN_EXTENSION;
+
+        aspirationWindow = DEFAULT_ASPIRATION_WINDOW;
+        multiPv = DEFAULT_MULTI_PV;
+
+        qsMaxPly = DEFAULT_QS_MAX_PLY;
+        deltaMargin = DEFAULT_DELTA_MARGIN;
+
+        lazyMargin = DEFAULT_LAZY_MARGIN;
+    }
+
+    // Fill the reduction table by depth and move number from lmrBase and lmrDivisor
+    void initReductions()
+    {
+        for (int d = 0; d < LMR_TABLE_SIZE; d++)
+        {
+            for (int m = 0; m < LMR_TABLE_SIZE; m++)
+            {
+                if (d == 0 || m == 0)
+                    reductions[d][m] = 0;
+                else
+                    reductions[d][m] = std::max(0, (int)(lmrBase / 100.0 + std::log(d) * std::log(m) * 100.0 / lmrDivisor));
+            }
+        }
+
+        return;
+    }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+SearchThread::SearchThread(const int& threadId, const unsigned int& seed) : rng(seed)
+{
+    id = threadId;
+    clear();
+}
+
+void SearchThread::clear()
+{
+    historyTable.clear();
+
+    for (int i = 0; i < MAX_PLY; i++)
+    {
+        killers[i][0] = 0;
+        killers[i][1] = 0;
+        nullMove[i] = false;
+        pvLength[i] = 0;
+    }
+    selDepth = 0;
+    bestPv.clear();
+    nullMoveMinPly = 0;
+
+    nodes = 0;
+    completedDepth = 0;
+    bestScore = -INFINITE_SCORE;
+
+    nullCutoffs = 0;
+    rfpCutoffs = 0;
+    razorCutoffs = 0;
+    futilityPrunes = 0;
+    reductions = 0;
+    researches = 0;
+    extensions = 0;
+    aspirationResearches = 0;
+    qsNodes = 0;
+    seePrunes = 0;
+    deltaPrunes = 0;
+    evalProbes = 0;
+    evalHits = 0;
+    lazyExits = 0;
+    lazyChecks = 0;
+    lazyErrors = 0;
+    pawnTable.probes = 0;
+    pawnTable.hits = 0;
+    materialTable.probes = 0;
+    materialTable.hits = 0;
+
+    return;
+}
+
+void SearchThread::clearPv(const int& ply)
+{
+    if (ply < MAX_PLY)
+        pvLength[ply] = ply;
+
+    selDepth = std::max(selDepth, ply);
+
+    return;
+}
+
+void SearchThread::updatePv(const int& ply, const uint16_t& move)
+{
+    if (ply >= MAX_PLY)
+        return;
+
+    int length = (ply + 1 < MAX_PLY) ? pvLength[ply + 1] : 0;
+
+    pv[ply][ply] = move;
+    for (int i = ply + 1; i < length; i++)
+        pv[ply][i] = pv[ply + 1][i];
+    pvLength[ply] = std::max(length, ply + 1);
+
+    return;
+}
+
+}
+}
@@ -0,0 +1,102 @@
+#ifndef SEARCH_THREAD_HPP
+#define SEARCH_THREAD_HPP
+
+////////////////////// History table type definition ///////////////////////
+struct key_hash
+{
+    std::size_t operator()(const MyMove& k) const
+    {
+        // Hash is: (id of piece + 1) ^ (final square)
+        return ((std::get<0>(k).id + 1) << 6) ^ ((std::get<0>(std::get<1>(k)) - 1) * FILE + (std::get<1>(std::get<1>(k)).at(0) - 'a'));
+    }
+};
+struct key_equal
+{
+    bool operator()(const MyMove& lhs, const MyMove& rhs) const
+    {
+        if (std::get<0>(lhs) == std::get<0>(rhs))
+        {
+            if (std::get<0>(std::get<1>(lhs)) == std::get<0>(std::get<1>(rhs)) && std::get<1>(std::get<1>(lhs)) == std::get<1>(std::get<1>(rhs)))
+                return true;
+        }
+
+        return false;
+    }
+};
+////////////////////////////////////////////////////////////////////////////
+
+using HistoryTable = std::unordered_map<MyMove, int, key_hash, key_equal>;
+
+// Everything a single search thread writes to. Threads only share the transposition table.
+// Padded by a cache line on both ends so counters of neighbouring threads never falsely share one
+// (over-aligned new is not available before C++17).
+struct SearchThread
+{
+    char frontPadding[64];
+
+    int id;
+
+    // Move ordering tables
+    HistoryTable historyTable;
+    uint16_t killers[MAX_PLY][2];
+
+    // Null move bookkeeping: no two null moves in a row, and none above nullMoveMinPly while verifying
+    bool nullMove[MAX_PLY];
+    int nullMoveMinPly;
+
+    // Random tie-breaking between equally ordered moves
+    std::mt19937 rng;
+
+    // Triangular principal variation table: pv[ply] holds the best line from ply, pvLength[ply] is where it ends
+    uint16_t pv[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+
+    // Deepest ply reached in the current iteration, quiescence search included
+    int selDepth;
+
+    // Atomic so the main thread can report the total while helpers are still counting
+    std::atomic<uint64_t> nodes;
+
+    // Results of the deepest iteration this thread has completed
+    std::atomic<int> completedDepth;
+    int bestScore;
+    MyMove bestMove;
+    std::vector<uint16_t> bestPv;
+
+    // Forward pruning statistics
+    uint64_t nullCutoffs;
+    uint64_t rfpCutoffs;
+    uint64_t razorCutoffs;
+    uint64_t futilityPrunes;
+    uint64_t reductions;
+    uint64_t researches;
+    uint64_t extensions;
+    uint64_t aspirationResearches;
+    uint64_t qsNodes;
+    uint64_t seePrunes;
+    uint64_t deltaPrunes;
+    uint64_t evalProbes;
+    uint64_t evalHits;
+    uint64_t lazyExits;
+    uint64_t lazyChecks;
+    uint64_t lazyErrors;
+
+    // Pawn structures analysed by this thread; probe statistics are kept by the table
+    PawnTable pawnTable;
+
+    // Material configurations seen by this thread, likewise
+    MaterialTable materialTable;
+
+    char backPadding[64];
+
+    SearchThread(const int& threadId, const unsigned int& seed);
+
+    // Reset the per-turn tables and results
+    void clear();
+
+    // Start an empty principal variation at a node, and make move followed by the line below it the one at ply
+    void clearPv(const int& ply);
+    void updatePv(const int& ply, const uint16_t& move);
+};
+
+#endif
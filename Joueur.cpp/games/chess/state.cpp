@@ -140,6 +140,20 @@ State::State()
             board[i][j].id = 0;
         }
     }
+
+    pieceKey = 0;
+    pawnKey = 0;
+    psqtMg = 0;
+    psqtEg = 0;
+    phase = 0;
+    material[0] = 0;
+    material[1] = 0;
+    for (int i = 0; i < 12; i++)
+        pieceCounts[i] = 0;
+    materialKey = 0;
+
+    if (network.isLoaded())
+        network.reset(accumulator.create());
 }
 
 // Copy Constructor (primarily used to generate child states)
@@ -164,6 +178,16 @@ State::State(const State& state, const int& fromRank, const std::string& fromFil
             board[i][j].id = state(i + 1, j).id;
         }
     }
+    pieceKey = state.getPieceKey();
+    pawnKey = state.getPawnKey();
+    psqtMg = state.getPsqtMg();
+    psqtEg = state.getPsqtEg();
+    phase = state.getPhase();
+    std::copy(state.material, state.material + 2, material);
+    std::copy(state.pieceCounts, state.pieceCounts + 12, pieceCounts);
+    materialKey = state.getMaterialKey();
+    if (network.isLoaded())
+        accumulator = state.accumulator;
 
     // Set king ranks from parent state for myself and opponent.
     if (pieceMoved.letter == 'K' || pieceMoved.letter == 'k')
@@ -502,137 +526,205 @@ void State::switchSides()
 // State evaluation heuristic function
 int State::stateHeuristic(const char& playerColor) const
 {
-    int value = 0;
+    // Promotions can push the phase past its starting value
+    int gamePhase = std::min(phase, MAX_PHASE);
+    int value = (psqtMg * gamePhase + psqtEg * (MAX_PHASE - gamePhase)) / MAX_PHASE;
+
+    return (playerColor == 'w') ? value : -value;
+}
+
+int State::nonPawnMaterial() const
+{
+    if (playerColor == 'w')
+        return material[0] - pieceCounts[pieceIndex('P')] * PAWN_VALUE;
+
+    return material[1] - pieceCounts[pieceIndex('p')] * PAWN_VALUE;
+}
 
-    // Iterates through all pieces, incrementing and decrementing based on the value of the piece
-    // and the player that is calling the state eval heuristic.
-    std::map<PieceInfo, std::tuple<int, std::string>, Comparator>::const_iterator it;
-    for (it = inPlay.begin(); it != inPlay.end(); it++)
+uint64_t State::pawnBitboard(const char& color) const
+{
+    uint64_t pawns = 0;
+
+    for (int i = 0; i < RANK; i++)
     {
-        switch(std::get<0>(*it).letter)
+        for (int j = 0; j < FILE; j++)
         {
-            case 'Q': value += (playerColor == 'w') ? 9 : -9; break;
-            case 'R': value += (playerColor == 'w') ? 5 : -5; break;
-            case 'B': value += (playerColor == 'w') ? 3 : -3; break;
-            case 'N': value += (playerColor == 'w') ? 3 : -3; break;
-            case 'P': value += (playerColor == 'w') ? 1 : -1; break;
-            case 'q': value += (playerColor == 'w') ? -9 : 9; break;
-            case 'r': value += (playerColor == 'w') ? -5 : 5; break;
-            case 'b': value += (playerColor == 'w') ? -3 : 3; break;
-            case 'n': value += (playerColor == 'w') ? -3 : 3; break;
-            case 'p': value += (playerColor == 'w') ? -1 : 1; break;
-            default: break;
+            if (isPawn(board[i][j]) && board[i][j].color == color)
+                pawns |= 1ULL << squareIndex(i + 1, j);
         }
     }
 
-    for (it = oppInPlay.begin(); it != oppInPlay.end(); it++)
+    return pawns;
+}
+
+void State::pieceBitboards(uint64_t bitboards[12]) const
+{
+    for (int piece = 0; piece < 12; piece++)
+        bitboards[piece] = 0;
+
+    for (int i = 0; i < RANK; i++)
     {
-        switch(std::get<0>(*it).letter)
+        for (int j = 0; j < FILE; j++)
         {
-            case 'Q': value += (playerColor == 'w') ? 9 : -9; break;
-            case 'R': value += (playerColor == 'w') ? 5 : -5; break;
-            case 'B': value += (playerColor == 'w') ? 3 : -3; break;
-            case 'N': value += (playerColor == 'w') ? 3 : -3; break;
-            case 'P': value += (playerColor == 'w') ? 1 : -1; break;
-            case 'q': value += (playerColor == 'w') ? -9 : 9; break;
-            case 'r': value += (playerColor == 'w') ? -5 : 5; break;
-            case 'b': value += (playerColor == 'w') ? -3 : 3; break;
-            case 'n': value += (playerColor == 'w') ? -3 : 3; break;
-            case 'p': value += (playerColor == 'w') ? -1 : 1; break;
-            default: break;
+            int piece = pieceIndex(board[i][j].letter);
+            if (piece != -1)
+                bitboards[piece] |= 1ULL << squareIndex(i + 1, j);
         }
     }
 
-    // Bonus points for castling
-    // To add later
-
-    return value;
+    return;
 }
 
-// Quiescent state evaluation function
-bool State::isQuiet()
+bool State::isPassedPawn(const int& rank, const std::string& file) const
 {
-    // For now, just checks if either player is in check. Returns false if one is in check.
-    if (!kingInCheck())
-    {
-        switchSides();
+    const PieceInfo& pawn = (*this)(rank, file);
+    int direction = (pawn.color == 'w') ? 1 : -1;
+    int f = convertFile(file);
 
-        if (!kingInCheck())
+    for (int r = rank + direction; r > 0 && r <= RANK; r += direction)
+    {
+        for (int c = std::max(0, f - 1); c <= std::min(FILE - 1, f + 1); c++)
         {
-            switchSides();
-            return true;
+            if (isPawn(board[r - 1][c]) && board[r - 1][c].color != pawn.color)
+                return false;
         }
-
-        switchSides();
     }
 
-    return false;
+    return true;
 }
 
-bool State::isDraw()
+int State::pieceValue(const PieceInfo& p) const
 {
-    // Three-fold repetition
-    if (prevMoves.size() == 8)
+    switch(toupper(p.letter))
     {
-        if (prevMoves.at(0) == prevMoves.at(4) && prevMoves.at(1) == prevMoves.at(5) && prevMoves.at(2) == prevMoves.at(6) && prevMoves.at(3) == prevMoves.at(7))
-            return true;
+        case 'Q': return QUEEN_VALUE;
+        case 'R': return ROOK_VALUE;
+        case 'B': return BISHOP_VALUE;
+        case 'N': return KNIGHT_VALUE;
+        case 'P': return PAWN_VALUE;
+        case 'K': return KING_VALUE;
+        default: return 0;
     }
+}
 
-    // Stalemate possibility
-    switchSides();
-    if (!kingInCheck() && kingInCheckMate())
-    {
-        switchSides();
-        return true;
-    }
-    switchSides();
+// Finds the least valuable piece of the given colour attacking a square of grid (0-based rank and file)
+static bool leastValuableAttacker(const State& state, const PieceInfo grid[RANK][FILE], const int& rank, const int& file, const char& color, int& attackerRank, int& attackerFile)
+{
+    int bestValue = INT_MAX;
 
-    // Insufficient material
-    if (inPlay.size() <= 2 && oppInPlay.size() <= 2)
+    // Keep the attacker on (r, c) if it is cheaper than the best one so far
+    auto consider = [&](const int r, const int c)
     {
-        // King vs. King
-        if (inPlay.size() == 1 && oppInPlay.size() == 1)
-            return true;
+        if (grid[r][c].color == color && state.pieceValue(grid[r][c]) < bestValue)
+        {
+            bestValue = state.pieceValue(grid[r][c]);
+            attackerRank = r;
+            attackerFile = c;
+        }
+    };
 
-        // King vs. Knight-King or King vs. Bishop-King
-        if (inPlay.size() == 1)
+    // Pawns attack diagonally forward, so look one rank behind the square
+    int pawnRank = (color == 'w') ? rank - 1 : rank + 1;
+    if (pawnRank >= 0 && pawnRank < RANK)
+    {
+        for (int c = file - 1; c <= file + 1; c += 2)
         {
-            int count = 0;
-            for (std::map<PieceInfo, std::tuple<int, std::string>, Comparator>::iterator it = oppInPlay.begin(); it != oppInPlay.end(); it++)
-                if (toupper(it->first.letter) == 'N' || toupper(it->first.letter) == 'K') {count++;}
-
-            if (count == 2)
-                return true;
-            ///////////////////////////////////////////////////////////////////
-            count = 0;
-            for (std::map<PieceInfo, std::tuple<int, std::string>, Comparator>::iterator it = oppInPlay.begin(); it != oppInPlay.end(); it++)
-                if (toupper(it->first.letter) == 'B' || toupper(it->first.letter) == 'K') {count++;}
-
-            if (count == 2)
-                return true;
+            if (c >= 0 && c < FILE && state.isPawn(grid[pawnRank][c]))
+                consider(pawnRank, c);
         }
+    }
 
-        // Knight-King vs. King or Bishop-King vs. King
-        switchSides();
-        if (inPlay.size() == 1)
+    for (int i = 0; i < 8; i++)
+    {
+        int r = rank + N_Offset[i][0], c = file + N_Offset[i][1];
+        if (r >= 0 && r < RANK && c >= 0 && c < FILE && state.isKnight(grid[r][c]))
+            consider(r, c);
+
+        r = rank + K_Offset[i][0];
+        c = file + K_Offset[i][1];
+        if (r >= 0 && r < RANK && c >= 0 && c < FILE && state.isKing(grid[r][c]))
+            consider(r, c);
+    }
+
+    // Sliders: the first piece along each ray, diagonals for bishops and orthogonals for rooks
+    for (int i = 0; i < 8; i++)
+    {
+        bool diagonal = (K_Offset[i][0] != 0 && K_Offset[i][1] != 0);
+        int r = rank + K_Offset[i][0], c = file + K_Offset[i][1];
+
+        while (r >= 0 && r < RANK && c >= 0 && c < FILE && grid[r][c].letter == '-')
         {
-            int count = 0;
-            for (std::map<PieceInfo, std::tuple<int, std::string>, Comparator>::iterator it = oppInPlay.begin(); it != oppInPlay.end(); it++)
-                if (toupper(it->first.letter) == 'N' || toupper(it->first.letter) == 'K') {count++;}
-
-            if (count == 2)
-                return true;
-            ///////////////////////////////////////////////////////////////////
-            count = 0;
-            for (std::map<PieceInfo, std::tuple<int, std::string>, Comparator>::iterator it = oppInPlay.begin(); it != oppInPlay.end(); it++)
-                if (toupper(it->first.letter) == 'B' || toupper(it->first.letter) == 'K') {count++;}
-
-            if (count == 2)
-                return true;
+            r += K_Offset[i][0];
+            c += K_Offset[i][1];
         }
-        switchSides();
+
+        if (r >= 0 && r < RANK && c >= 0 && c < FILE && (state.isQueen(grid[r][c]) || (diagonal ? state.isBishop(grid[r][c]) : state.isRook(grid[r][c]))))
+            consider(r, c);
+    }
+
+    return bestValue != INT_MAX;
+}
+
+// Static exchange evaluation: material won (negative if lost) by the side to play after the best sequence of
+// recaptures on the destination square, each side being free to stop capturing whenever it pleases
+int State::staticExchange(const int& fromRank, const std::string& fromFile, const std::tuple<int, std::string, std::string>& move) const
+{
+    PieceInfo grid[RANK][FILE];
+    for (int i = 0; i < RANK; i++)
+        for (int j = 0; j < FILE; j++)
+            grid[i][j] = board[i][j];
+
+    int toRank = std::get<0>(move) - 1;
+    int toFile = convertFile(std::get<1>(move));
+    int attackerRank = fromRank - 1;
+    int attackerFile = convertFile(fromFile);
+    char color = grid[attackerRank][attackerFile].color;
+
+    // gain[d] is the score of the exchange if it stopped after d + 1 captures
+    int gain[32];
+    int d = 0;
+    gain[0] = pieceValue(grid[toRank][toFile]);
+
+    // The pawn taken en passant is not on the destination square
+    if (std::get<2>(move) == "EN PASSANT")
+    {
+        gain[0] = PAWN_VALUE;
+        grid[attackerRank][toFile] = PieceInfo();
     }
 
+    do
+    {
+        d++;
+        gain[d] = pieceValue(grid[attackerRank][attackerFile]) - gain[d - 1];
+
+        // Move the attacker onto the square, uncovering any slider behind it
+        grid[toRank][toFile] = grid[attackerRank][attackerFile];
+        grid[attackerRank][attackerFile] = PieceInfo();
+        color = (color == 'w') ? 'b' : 'w';
+    } while (d < 31 && leastValuableAttacker(*this, grid, toRank, toFile, color, attackerRank, attackerFile));
+
+    while (--d)
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+
+    return gain[0];
+}
+
+bool State::isDraw()
+{
+    // Three-fold repetition
+    if (prevMoves.size() == 8)
+    {
+        if (prevMoves.at(0) == prevMoves.at(4) && prevMoves.at(1) == prevMoves.at(5) && prevMoves.at(2) == prevMoves.at(6) && prevMoves.at(3) == prevMoves.at(7))
+            return true;
+    }
+
+    // Stalemate is left to the search, which finds it from the empty move list
+
+    // Insufficient material: bare kings, or a lone knight or bishop against a bare king
+    const EndgameEntry* endgame = endgames.probe(materialKey);
+    if (endgame && endgame->insufficient)
+        return true;
+
     // 50 move rule
     if (moveTracker == 50)
     {
@@ -736,9 +828,11 @@ void State::setBoard(const char& c, const char& l, const int& num, const int a,
         oppColor = '-';
 
     // Set PieceInfo in the board
+    toggleSquare(a, b, -1);
     board[a - 1][b].letter = l;
     board[a - 1][b].color = c;
     board[a - 1][b].id = num;
+    toggleSquare(a, b, 1);
 
     // Keep tabs on where pieces are using maps.
     if (playerColor == c)
@@ -749,6 +843,143 @@ void State::setBoard(const char& c, const char& l, const int& num, const int a,
     return;
 }
 
+void State::loadFen(const std::string& fen, const std::string& color)
+{
+    // Set the color for this player
+    setPlayerColor(color);
+
+    // Variables to parse the FEN string
+    int index = 0, i = 8, j = 0;
+
+    // Info to construct a PieceInfo struct (my version of the framework's Piece)
+    char l = fen.at(index);
+    char pieceColor;
+    int id = 1;
+
+    // Determine color of piece
+    if (islower(l))
+        pieceColor = 'b';
+    else if (isupper(l))
+        pieceColor = 'w';
+    else
+        pieceColor = '-';
+
+    // Parse string one character at a time
+    while (l != ' ')
+    {
+        if (l > '0' && l < '9')
+        {
+            for (int k = 0; k < (l - '0'); ++k)
+            {
+                setBoard(pieceColor, '-', 0, i, j);
+                j++;
+            }
+        }
+        else if (l == '/')
+        {
+            j = 0;
+            i--;
+        }
+        else
+        {
+            setBoard(pieceColor, l, id, i, j);
+            id++;
+            j++;
+        }
+        index++;
+        l = fen.at(index);
+
+        // Update color of new char
+        if (islower(l))
+            pieceColor = 'b';
+        else if (isupper(l))
+            pieceColor = 'w';
+        else
+            pieceColor = '-';
+    }
+
+    // Get to the portion of the string with castling info
+    index += 3;
+    l = fen.at(index);
+    while (l != ' ')
+    {
+        if (l == 'K' && getPlayerColor() == 'w')
+            myKingCanCastle();
+        else if (l == 'K')
+            oppKingCanCastle();
+        else if (l == 'Q' && getPlayerColor() == 'w')
+            myQueenCanCastle();
+        else if (l == 'Q')
+            oppQueenCanCastle();
+        else if (l == 'k' && getPlayerColor() == 'b')
+            myKingCanCastle();
+        else if (l == 'k')
+            oppKingCanCastle();
+        else if (l == 'q' && getPlayerColor() == 'b')
+            myQueenCanCastle();
+        else if (l == 'q')
+            oppQueenCanCastle();
+
+        index++;
+        l = fen.at(index);
+    }
+
+    // Get to the portion of the string with en passant info
+    index++;
+    l = fen.at(index);
+    if (l == '-')
+        setEnPassant(-1, "NULL");
+    else
+    {
+        index++;
+        std::string file(1, l);
+        int rank = fen.at(index) - '0';
+
+        setEnPassant(rank, file);
+    }
+
+    // Get to portion of string with halfmove clock info.
+    index += 2;
+    std::string number;
+    while (fen.at(index) != ' ')
+    {
+        number += fen.at(index);
+        index++;
+    }
+    setMoveTracker(std::stoi(number) / 2);
+
+    // Keep track of both King's position
+    for (int i = 1 ; i <= RANK; i++)
+    {
+        for (int j = 0; j < FILE; j++)
+        {
+            if ((*this)(i, j).letter == 'K' && getPlayerColor() == 'w')
+            {
+                setMyKingRank(i);
+                setMyKingFile(convertToFile(j + 1));
+            }
+            else if ((*this)(i, j).letter == 'K')
+            {
+                setOppKingRank(i);
+                setOppKingFile(convertToFile(j + 1));
+            }
+
+            if ((*this)(i, j).letter == 'k' && getPlayerColor() == 'b')
+            {
+                setMyKingRank(i);
+                setMyKingFile(convertToFile(j + 1));
+            }
+            else if ((*this)(i, j).letter == 'k')
+            {
+                setOppKingRank(i);
+                setOppKingFile(convertToFile(j + 1));
+            }
+        }
+    }
+
+    return;
+}
+
 void State::setEnPassant(const int& rank, const std::string& file)
 {
     enPassantSpace = std::make_tuple(rank, file);
@@ -760,9 +991,12 @@ void State::add(const PieceInfo p, const int a, const std::string& b)
 {
     int d = convertFile(b);
 
+    // Hash out a captured piece before hashing in the new one
+    toggleSquare(a, d, -1);
     board[a - 1][d].letter = p.letter;
     board[a - 1][d].color = p.color;
     board[a - 1][d].id = p.id;
+    toggleSquare(a, d, 1);
 
     return;
 }
@@ -771,6 +1005,7 @@ void State::remove(const int a, const std::string& b)
 {
     int c = convertFile(b);
 
+    toggleSquare(a, c, -1);
     board[a - 1][c].letter = '-';
     board[a - 1][c].color = '-';
     board[a - 1][c].id = 0;
@@ -778,6 +1013,124 @@ void State::remove(const int a, const std::string& b)
     return;
 }
 
+void State::toggleSquare(const int a, const int c, const int sign)
+{
+    int piece = pieceIndex(board[a - 1][c].letter);
+
+    if (piece == -1)
+        return;
+
+    int square = squareIndex(a, c);
+    pieceKey ^= zobrist.pieces[piece][square];
+
+    if (isPawn(board[a - 1][c]))
+        pawnKey ^= zobrist.pieces[piece][square];
+
+    // White pieces are the first six indices; black ones read the tables from their own side of the board
+    int type = piece % 6;
+    int relativeSquare = (piece < 6) ? square : (square ^ 56);
+    int colorSign = (piece < 6) ? sign : -sign;
+
+    psqtMg += colorSign * (evalParams.pieceMg[type] + evalParams.psqtMg[type][relativeSquare]);
+    psqtEg += colorSign * (evalParams.pieceEg[type] + evalParams.psqtEg[type][relativeSquare]);
+    phase += sign * PHASE_WEIGHT[type];
+    material[(piece < 6) ? 0 : 1] += sign * PIECE_TYPE_VALUE[type];
+    pieceCounts[piece] += sign;
+    materialKey = (sign > 0) ? materialKey + materialKeyUnit(piece) : materialKey - materialKeyUnit(piece);
+
+    if (accumulator)
+        network.update(*accumulator, piece, square, sign);
+
+    return;
+}
+
+void State::refreshAccumulator()
+{
+    network.reset(accumulator.create());
+
+    for (int i = 1; i <= RANK; i++)
+    {
+        for (int j = 0; j < FILE; j++)
+        {
+            int piece = pieceIndex(board[i - 1][j].letter);
+            if (piece != -1)
+                network.update(*accumulator, piece, squareIndex(i, j), 1);
+        }
+    }
+
+    return;
+}
+
+uint64_t State::getHashKey() const
+{
+    uint64_t key = pieceKey;
+
+    // Castling rights are kept relative to the side to play, hash them by colour
+    bool white = (playerColor == 'w');
+    int rights = ((white ? myKingCastle : oppKingCastle) ? 1 : 0)
+               | ((white ? myQueenCastle : oppQueenCastle) ? 2 : 0)
+               | ((white ? oppKingCastle : myKingCastle) ? 4 : 0)
+               | ((white ? oppQueenCastle : myQueenCastle) ? 8 : 0);
+    key ^= zobrist.castling[rights];
+
+    if (std::get<0>(enPassantSpace) > 0)
+        key ^= zobrist.enPassant[convertFile(std::get<1>(enPassantSpace))];
+
+    if (!white)
+        key ^= zobrist.side;
+
+    return key;
+}
+
+std::tuple<int, std::string> State::findLocation(const PieceInfo& p) const
+{
+    std::map<PieceInfo, std::tuple<int, std::string>, Comparator>::const_iterator it = inPlay.find(p);
+
+    if (it != inPlay.end())
+        return it->second;
+
+    it = oppInPlay.find(p);
+    if (it != oppInPlay.end())
+        return it->second;
+
+    return std::make_tuple(-1, "NULL");
+}
+
+uint16_t State::packMove(const int& fromRank, const std::string& fromFile, const std::tuple<int, std::string, std::string>& move) const
+{
+    int promotion = 0;
+
+    if (std::get<2>(move) == "Knight")
+        promotion = 1;
+    else if (std::get<2>(move) == "Bishop")
+        promotion = 2;
+    else if (std::get<2>(move) == "Rook")
+        promotion = 3;
+    else if (std::get<2>(move) == "Queen")
+        promotion = 4;
+
+    return (uint16_t)(squareIndex(fromRank, convertFile(fromFile))
+                    | (squareIndex(std::get<0>(move), convertFile(std::get<1>(move))) << 6)
+                    | (promotion << 12));
+}
+
+// Coordinate notation of a packed move, e.g. e7e8q
+std::string State::moveString(const uint16_t& move) const
+{
+    const char promotions[5] = {' ', 'n', 'b', 'r', 'q'};
+    std::string text;
+
+    text += convertToFile((move & 63) % FILE + 1);
+    text += std::to_string((move & 63) / FILE + 1);
+    text += convertToFile(((move >> 6) & 63) % FILE + 1);
+    text += std::to_string(((move >> 6) & 63) / FILE + 1);
+
+    if ((move >> 12) > 0 && (move >> 12) < 5)
+        text += promotions[move >> 12];
+
+    return text;
+}
+
 void State::printPieces() const
 {
     for (std::map<PieceInfo, std::tuple<int, std::string>>::const_iterator it = inPlay.begin(); it != inPlay.end(); it++)
@@ -813,6 +1166,24 @@ void State::printPrevMoves()
 }
 
 // Function to generate all of the valid child states of a particular state
+void State::pieceMoves(const PieceInfo& piece, const std::tuple<int, std::string>& rankFile, std::vector<std::tuple<int, std::string, std::string>>& possibleMoves) const
+{
+    if (toupper(piece.letter) == 'P')
+        pawnMoves(piece, rankFile, possibleMoves);
+    else if (toupper(piece.letter) == 'R')
+        rookMoves(piece, rankFile, possibleMoves);
+    else if (toupper(piece.letter) == 'N')
+        knightMoves(piece, rankFile, possibleMoves);
+    else if (toupper(piece.letter) == 'B')
+        bishopMoves(piece, rankFile, possibleMoves);
+    else if (toupper(piece.letter) == 'Q')
+        queenMoves(piece, rankFile, possibleMoves);
+    else
+        kingMoves(piece, rankFile, possibleMoves);
+
+    return;
+}
+
 std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>> State::generateChildren() const
 {
     // Container for child states with associated move that results in that child state
@@ -827,18 +1198,7 @@ std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::strin
         PieceInfo piece = it->first;
         auto rankFile = it->second;
 
-        if (toupper(piece.letter) == 'P')
-            pawnMoves(piece, rankFile, possibleMoves);
-        else if (toupper(piece.letter) == 'R')
-            rookMoves(piece, rankFile, possibleMoves);
-        else if (toupper(piece.letter) == 'N')
-            knightMoves(piece, rankFile, possibleMoves);
-        else if (toupper(piece.letter) == 'B')
-            bishopMoves(piece, rankFile, possibleMoves);
-        else if (toupper(piece.letter) == 'Q')
-            queenMoves(piece, rankFile, possibleMoves);
-        else
-            kingMoves(piece, rankFile, possibleMoves);
+        pieceMoves(piece, rankFile, possibleMoves);
 
         /*if (possibleMoves.size() != 0)
             std::cout << "Possible states:" << std::endl;*/
@@ -860,18 +1220,59 @@ std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::strin
     return childStates;
 }
 
+// Same as generateChildren, restricted to captures (en passant included) and promotions
+std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>> State::generateCaptures() const
+{
+    std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>> childStates;
+
+    for (std::map<PieceInfo, std::tuple<int, std::string>>::const_iterator it = inPlay.begin(); it != inPlay.end(); it++)
+    {
+        std::vector<std::tuple<int, std::string, std::string>> possibleMoves;
+        PieceInfo piece = it->first;
+        auto rankFile = it->second;
+
+        pieceMoves(piece, rankFile, possibleMoves);
+
+        for (unsigned int i = 0; i < possibleMoves.size(); i++)
+        {
+            const std::tuple<int, std::string, std::string>& move = possibleMoves.at(i);
+            if (isEmpty(std::get<0>(move), std::get<1>(move)) && !isPromotion(std::get<2>(move)) && std::get<2>(move) != "EN PASSANT")
+                continue;
+
+            State child(*this, std::get<0>(rankFile), std::get<1>(rankFile), move);
+
+            if (!child.kingInCheck())
+                childStates.push_back(std::make_tuple(child, piece, move));
+        }
+    }
+
+    return childStates;
+}
+
 bool State::kingInCheck() const
+{
+    return kingAttacked(myKingRank, myKingFile, playerColor);
+}
+
+// True if the opponent's king is attacked, i.e. the move that produced this state gives check
+bool State::oppKingInCheck() const
+{
+    return kingAttacked(oppKingRank, oppKingFile, (playerColor == 'w') ? 'b' : 'w');
+}
+
+// True if the king of the given colour standing on the given square is attacked
+bool State::kingAttacked(const int& kingRank, const std::string& kingFile, const char& color) const
 {
     int r;
     std::string f;
 
     ///////////// Check if king is in check by opposing rook/queen /////////////
-    r = myKingRank + 1;
-    f = myKingFile;
+    r = kingRank + 1;
+    f = kingFile;
     while (r <= RANK)
     {
         // In check by opposing rook/queen
-        if (isOpponent(playerColor, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
+        if (isOpponent(color, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
             return true;
         // Empty space, keep looking
         else if (isEmpty(r, f))
@@ -881,10 +1282,10 @@ bool State::kingInCheck() const
             break;
     }
 
-    r = myKingRank - 1;
+    r = kingRank - 1;
     while (r > 0)
     {
-        if (isOpponent(playerColor, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
+        if (isOpponent(color, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
             return true;
         else if (isEmpty(r, f))
             r--;
@@ -892,11 +1293,11 @@ bool State::kingInCheck() const
             break;
     }
 
-    r = myKingRank;
-    f = rightFile(myKingFile);
+    r = kingRank;
+    f = rightFile(kingFile);
     while (f != "NULL")
     {
-        if (isOpponent(playerColor, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
+        if (isOpponent(color, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
             return true;
         else if (isEmpty(r, f))
             f = rightFile(f);
@@ -904,10 +1305,10 @@ bool State::kingInCheck() const
             break;
     }
 
-    f = leftFile(myKingFile);
+    f = leftFile(kingFile);
     while (f != "NULL")
     {
-        if (isOpponent(playerColor, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
+        if (isOpponent(color, r, f) && (isRook(this->operator()(r, f)) || (isQueen(this->operator()(r, f)))))
             return true;
         else if (isEmpty(r, f))
             f = leftFile(f);
@@ -917,11 +1318,11 @@ bool State::kingInCheck() const
     ////////////////////////////////////////////////////////////////////////////
 
     //////////// Check if king is in check by opposing bishop/queen ////////////
-    r = myKingRank + 1;
-    f = leftFile(myKingFile);
+    r = kingRank + 1;
+    f = leftFile(kingFile);
     while (r <= RANK && f != "NULL")
     {
-        if (isOpponent(playerColor, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
+        if (isOpponent(color, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
             return true;
         else if (isEmpty(r, f))
         {
@@ -932,11 +1333,11 @@ bool State::kingInCheck() const
             break;
     }
 
-    r = myKingRank + 1;
-    f = rightFile(myKingFile);
+    r = kingRank + 1;
+    f = rightFile(kingFile);
     while (r <= RANK && f != "NULL")
     {
-        if (isOpponent(playerColor, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
+        if (isOpponent(color, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
             return true;
         else if (isEmpty(r, f))
         {
@@ -947,11 +1348,11 @@ bool State::kingInCheck() const
             break;
     }
 
-    r = myKingRank - 1;
-    f = leftFile(myKingFile);
+    r = kingRank - 1;
+    f = leftFile(kingFile);
     while (r > 0 && f != "NULL")
     {
-        if (isOpponent(playerColor, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
+        if (isOpponent(color, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
             return true;
         else if (isEmpty(r, f))
         {
@@ -962,11 +1363,11 @@ bool State::kingInCheck() const
             break;
     }
 
-    r = myKingRank - 1;
-    f = rightFile(myKingFile);
+    r = kingRank - 1;
+    f = rightFile(kingFile);
     while (r > 0 && f != "NULL")
     {
-        if (isOpponent(playerColor, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
+        if (isOpponent(color, r, f) && (isBishop(this->operator()(r, f)) || (isQueen(this->operator()(r,f)))))
             return true;
         else if (isEmpty(r, f))
         {
@@ -980,89 +1381,89 @@ bool State::kingInCheck() const
 
     ////////////// Check if king is in check by opposing knight ////////////////
 
-    r = myKingRank + 2;
-    f = rightFile(myKingFile);
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    r = kingRank + 2;
+    f = rightFile(kingFile);
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    f = leftFile(myKingFile);
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    f = leftFile(kingFile);
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    r = myKingRank + 1;
-    f = rightFile(rightFile(myKingFile));
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    r = kingRank + 1;
+    f = rightFile(rightFile(kingFile));
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    f = leftFile(leftFile(myKingFile));
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    f = leftFile(leftFile(kingFile));
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    r = myKingRank - 2;
-    f = rightFile(myKingFile);
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    r = kingRank - 2;
+    f = rightFile(kingFile);
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    f = leftFile(myKingFile);
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    f = leftFile(kingFile);
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    r = myKingRank - 1;
-    f = rightFile(rightFile(myKingFile));
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    r = kingRank - 1;
+    f = rightFile(rightFile(kingFile));
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
 
-    f = leftFile(leftFile(myKingFile));
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKnight(this->operator()(r, f)))
+    f = leftFile(leftFile(kingFile));
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKnight(this->operator()(r, f)))
         return true;
     ////////////////////////////////////////////////////////////////////////////
 
     /////////////// Check if king is in check by opposing pawns ////////////////
-    r = (playerColor == 'w') ? (myKingRank + 1) : (myKingRank - 1);
-    f = leftFile(myKingFile);
-    if (r <= RANK && r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isPawn(this->operator()(r, f)))
+    r = (color == 'w') ? (kingRank + 1) : (kingRank - 1);
+    f = leftFile(kingFile);
+    if (r <= RANK && r > 0 && f != "NULL" && isOpponent(color, r, f) && isPawn(this->operator()(r, f)))
         return true;
 
-    f = rightFile(myKingFile);
-    if (r <= RANK && r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isPawn(this->operator()(r, f)))
+    f = rightFile(kingFile);
+    if (r <= RANK && r > 0 && f != "NULL" && isOpponent(color, r, f) && isPawn(this->operator()(r, f)))
         return true;
     ////////////////////////////////////////////////////////////////////////////
 
     ////////////// Check if king is in check by opposing king //////////////////
 
-    r = myKingRank + 1;
-    f = myKingFile;
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    r = kingRank + 1;
+    f = kingFile;
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    f = leftFile(myKingFile);
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    f = leftFile(kingFile);
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    f = rightFile(myKingFile);
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    f = rightFile(kingFile);
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    r = myKingRank;
-    f = leftFile(myKingFile);
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    r = kingRank;
+    f = leftFile(kingFile);
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    f = rightFile(myKingFile);
-    if (r <= RANK && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    f = rightFile(kingFile);
+    if (r <= RANK && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    r = myKingRank - 1;
-    f = myKingFile;
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    r = kingRank - 1;
+    f = kingFile;
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    f = leftFile(myKingFile);
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    f = leftFile(kingFile);
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
-    f = rightFile(myKingFile);
-    if (r > 0 && f != "NULL" && isOpponent(playerColor, r, f) && isKing(this->operator()(r, f)))
+    f = rightFile(kingFile);
+    if (r > 0 && f != "NULL" && isOpponent(color, r, f) && isKing(this->operator()(r, f)))
         return true;
 
     return false;
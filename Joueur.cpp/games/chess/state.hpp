@@ -5,6 +5,16 @@
 const int K_Offset[8][2] = {{1,-1},{1,0},{1,1},{0,-1},{0,1},{-1,-1},{-1,0},{-1,1}};
 const int N_Offset[8][2] = {{2,-1},{2,1},{1,2},{1,-2},{-1,-2},{-1,2},{-2,-1},{-2,1}};
 
+// Piece values (in centipawns)
+const int PAWN_VALUE = 100;
+const int KNIGHT_VALUE = 300;
+const int BISHOP_VALUE = 300;
+const int ROOK_VALUE = 500;
+const int QUEEN_VALUE = 900;
+
+// Only used to order and resolve exchanges, never in the evaluation
+const int KING_VALUE = 20000;
+
 struct PieceInfo
 {
     char letter, color;
@@ -47,6 +57,36 @@ class State
         // For 50 move rule
         int moveTracker;
 
+        // Zobrist key of the pieces on the board, updated whenever a square changes
+        uint64_t pieceKey;
+
+        // Zobrist key of the pawns alone, for the pawn structure table
+        uint64_t pawnKey;
+
+        // Piece-square sums (material included) for the middlegame and endgame, white minus black, and the game phase
+        int psqtMg;
+        int psqtEg;
+        int phase;
+
+        // Material (in centipawns, kings excluded) by colour, 0 = white and 1 = black, and piece counts by pieceIndex
+        int material[2];
+        int pieceCounts[12];
+
+        // Piece counts packed into one signature (see materialKeyUnit), the key of the endgame table
+        uint64_t materialKey;
+
+        // First layer of the network evaluation, only allocated and kept up to date while a network is loaded
+        AccumulatorPtr accumulator;
+
+        // XOR the key of whatever piece is on a square in or out of pieceKey (and pawnKey for a pawn),
+        // and add it to (sign 1) or take it off (sign -1) the piece-square sums, phase, material, piece counts and material key
+        void toggleSquare(const int a, const int c, const int sign);
+
+        bool kingAttacked(const int& kingRank, const std::string& kingFile, const char& color) const;
+
+        // Pseudo-legal moves of a single piece
+        void pieceMoves(const PieceInfo& piece, const std::tuple<int, std::string>& rankFile, std::vector<std::tuple<int, std::string, std::string>>& possibleMoves) const;
+
     public:
         State();
         State(const State& state, const int& fromRank, const std::string& fromFile, const std::tuple<int, std::string, std::string>& move);
@@ -70,6 +110,17 @@ class State
         char getPlayerColor() const {return playerColor;}
         std::vector<std::tuple<std::tuple<int, std::string>, std::tuple<int, std::string>>> getPrevMoves() const {return prevMoves;}
         int getMoveTracker() const {return moveTracker;}
+        uint64_t getPieceKey() const {return pieceKey;}
+        uint64_t getPawnKey() const {return pawnKey;}
+        int getPsqtMg() const {return psqtMg;}
+        int getPsqtEg() const {return psqtEg;}
+        int getPhase() const {return phase;}
+        const Accumulator& getAccumulator() const {return *accumulator;}
+        int getMaterial(const char& color) const {return material[(color == 'w') ? 0 : 1];}
+        int pieceCount(const char& letter) const {return pieceCounts[pieceIndex(letter)];}
+        uint64_t getMaterialKey() const {return materialKey;}
+        uint64_t getHashKey() const;
+        std::tuple<int, std::string> findLocation(const PieceInfo& p) const;
         bool kingCastleStatus() const {return myKingCastle;}
         bool queenCastleStatus() const {return myQueenCastle;}
         bool oppKingCastleStatus() const {return oppKingCastle;}
@@ -78,6 +129,8 @@ class State
 
         // Mutators
         void setBoard(const char& c, const char& l, const int& num, const int a, const int b);
+        // Set up an empty state from a FEN, with the given player ("White" or "Black") as "my" side
+        void loadFen(const std::string& fen, const std::string& color);
         void setMyKingRank(const int& rank) {myKingRank = rank; return;}
         void setMyKingFile(const std::string& file) {myKingFile = file; return;}
         void setOppKingRank(const int& rank) {oppKingRank = rank; return;}
@@ -94,6 +147,9 @@ class State
         void add(const PieceInfo p, const int a, const std::string& b);
         void remove(const int a, const std::string& b);
 
+        // Recompute the accumulator from the board, for states set up before the network was loaded
+        void refreshAccumulator();
+
         // Piece moving functions
         void pawnMoves(const PieceInfo& p, const std::tuple<int, std::string>& rankFile, std::vector<std::tuple<int, std::string, std::string>>& possibleMoves) const;
         void rookMoves(const PieceInfo& r, const std::tuple<int, std::string>& rankFile, std::vector<std::tuple<int, std::string, std::string>>& possibleMoves) const;
@@ -114,6 +170,7 @@ class State
         bool isPawn(const PieceInfo& p) const;
         bool isKing(const PieceInfo& p) const;
         bool isPromotion(const std::string& promotion) const;
+        int pieceValue(const PieceInfo& p) const;
 
         // File conversion and file neighbor functions
         int convertFile(const std::string& file) const;
@@ -124,10 +181,15 @@ class State
         int getRank(std::tuple<int, std::string> p) const {return std::get<0>(p);}
         std::string getFile(std::tuple<int, std::string> p) const {return std::get<1>(p);}
 
+        // Compact move encoding used by the transposition table: from (6 bits) | to (6 bits) | promotion (3 bits)
+        uint16_t packMove(const int& fromRank, const std::string& fromFile, const std::tuple<int, std::string, std::string>& move) const;
+        std::string moveString(const uint16_t& move) const;
+
         ////////////////////////////////////////////////////////////////////////
 
         // Function to ascertain if king is in check
         bool kingInCheck() const;
+        bool oppKingInCheck() const;
 
         bool kingInCheckMate() const;
 
@@ -138,6 +200,10 @@ class State
 
         // Children state generation
         std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>> generateChildren() const;
+        std::vector<std::tuple<State, PieceInfo, std::tuple<int, std::string, std::string>>> generateCaptures() const;
+
+        // Static exchange evaluation of a capture (in centipawns, for the side making it)
+        int staticExchange(const int& fromRank, const std::string& fromFile, const std::tuple<int, std::string, std::string>& move) const;
 
         // Update state when opponent makes a move
         void updateState(const int fromRank, const std::string fromFile, const int toRank, const std::string toFile, const std::string promotion);
@@ -145,11 +211,20 @@ class State
         // Switch sides
         void switchSides();
 
-        // State evaluation heuristic function
+        // State evaluation heuristic function: piece-square sums blended by game phase
         int stateHeuristic(const char& playerColor) const;
 
-        // Quiescent state evaluation
-        bool isQuiet();
+        // Material of the side to play other than pawns and king
+        int nonPawnMaterial() const;
+
+        // Squares (bit squareIndex) holding a pawn of the given colour
+        uint64_t pawnBitboard(const char& color) const;
+
+        // Squares (bit squareIndex) of every piece, by pieceIndex
+        void pieceBitboards(uint64_t bitboards[12]) const;
+
+        // True if no enemy pawn can block or capture the pawn on this square on its way to promotion
+        bool isPassedPawn(const int& rank, const std::string& file) const;
 
         // Terminal state evaluation functions
         bool isDraw();
@@ -0,0 +1,100 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+TimeManager::TimeManager()
+{
+    startTicks = std::chrono::steady_clock::now().time_since_epoch().count();
+    softLimit = 0.0;
+    hardLimit = 0.0;
+    pondering = false;
+    startSearch();
+}
+
+void TimeManager::startTurn(const double& timeRemainingNs, const int& currentTurn, const int& maxTurns, const double& overheadMs)
+{
+    startTicks = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    double remaining = timeRemainingNs / 1e9;
+    double overhead = overheadMs / 1000.0;
+
+    // Plies left before the game is automatically ended, half of which are ours
+    int ourMovesLeft = (maxTurns - currentTurn + 1) / 2;
+    int movesToGo = std::max(1, std::min(ourMovesLeft, MOVES_HORIZON));
+
+    // Keep the server round-trip in reserve for this move and every move in the horizon
+    double usable = std::max(0.0, remaining - overhead * movesToGo);
+
+    double soft = usable / movesToGo;
+    double hard = std::min(usable * MAX_MOVE_FRACTION, soft * HARD_SOFT_RATIO);
+
+    // The hard limit never falls below the soft one
+    if (hard < soft)
+        hard = soft;
+
+    // Nearly flagging: spend half of whatever is left over the reserve and nothing more
+    if (usable <= 0.0)
+    {
+        soft = std::max(0.0, (remaining - overhead) / 2.0);
+        hard = soft;
+    }
+
+    softLimit = soft;
+    hardLimit = hard;
+
+    return;
+}
+
+void TimeManager::extendSoft(const double& factor)
+{
+    softLimit = std::min(softLimit * factor, hardLimit.load());
+
+    return;
+}
+
+void TimeManager::startSearch()
+{
+    lastIteration = 0.0;
+    branchingFactor = DEFAULT_EBF;
+    startIteration();
+
+    return;
+}
+
+void TimeManager::startIteration()
+{
+    iterationTicks = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    return;
+}
+
+void TimeManager::endIteration()
+{
+    std::chrono::steady_clock::time_point iterationStart{std::chrono::steady_clock::duration(iterationTicks.load())};
+
+    double previous = lastIteration;
+    lastIteration = std::chrono::duration<double>(std::chrono::steady_clock::now() - iterationStart).count();
+
+    if (previous > 0.0)
+        branchingFactor = (branchingFactor + std::max(MIN_EBF, std::min(MAX_EBF, lastIteration / previous))) / 2.0;
+
+    return;
+}
+
+double TimeManager::predictIteration() const
+{
+    return lastIteration * branchingFactor;
+}
+
+double TimeManager::elapsed() const
+{
+    std::chrono::steady_clock::time_point startTime{std::chrono::steady_clock::duration(startTicks.load())};
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+}
+}
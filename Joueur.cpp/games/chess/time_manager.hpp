@@ -0,0 +1,72 @@
+#ifndef TIME_MANAGER_HPP
+#define TIME_MANAGER_HPP
+
+// Number of our own moves the remaining clock is spread across when the game is far from max_turns
+#define MOVES_HORIZON 40
+
+// Cap on the share of the remaining clock a single move may ever use
+#define MAX_MOVE_FRACTION 0.25
+
+// Hard budget as a multiple of the soft budget
+#define HARD_SOFT_RATIO 4.0
+
+// Default round-trip allowance for the server (in ms), overridable with move_overhead=<ms>
+#define DEFAULT_MOVE_OVERHEAD 200
+
+// Effective branching factor assumed before any iterations have been timed, and the range each measured one is kept in.
+// Every measured ratio between consecutive iterations is averaged into the running estimate.
+#define DEFAULT_EBF 4.0
+#define MIN_EBF 1.5
+#define MAX_EBF 8.0
+
+// Allocates a soft and hard wall-clock budget for each move from the player's remaining time.
+// The soft budget decides whether a new iteration is started, the hard budget aborts a running one.
+// Members are atomic because a ponder search keeps reading them while the next turn is being set up.
+class TimeManager
+{
+    private:
+        std::atomic<std::chrono::steady_clock::rep> startTicks;
+        std::atomic<double> softLimit;
+        std::atomic<double> hardLimit;
+
+        // While pondering neither budget ever expires
+        std::atomic<bool> pondering;
+
+        // Wall-clock time of the last completed iteration (in seconds), the effective branching factor so far
+        // and when the running iteration started,
+        // kept apart from startTicks so a ponder hit doesn't disturb them
+        std::atomic<double> lastIteration;
+        std::atomic<double> branchingFactor;
+        std::atomic<std::chrono::steady_clock::rep> iterationTicks;
+
+    public:
+        TimeManager();
+
+        // Start the clock for a new turn and compute both budgets (in seconds)
+        void startTurn(const double& timeRemainingNs, const int& currentTurn, const int& maxTurns, const double& overheadMs);
+
+        // Scale the soft budget (e.g. think longer when losing), never beyond the hard budget
+        void extendSoft(const double& factor);
+
+        void setPondering(const bool& ponder) {pondering = ponder; return;}
+
+        // Iteration timing for the main thread's iterative deepening
+        void startSearch();
+        void startIteration();
+        void endIteration();
+
+        // Expected duration of the next iteration: the last one times the effective branching factor
+        double predictIteration() const;
+
+        // True if the next iteration is expected to finish within the soft budget
+        bool iterationFits() const {return pondering || elapsed() + predictIteration() <= softLimit;}
+
+        // Accessors
+        double elapsed() const;
+        double getSoftLimit() const {return softLimit;}
+        double getHardLimit() const {return hardLimit;}
+        bool isPondering() const {return pondering;}
+        bool hardExpired() const {return !pondering && elapsed() >= hardLimit;}
+};
+
+#endif
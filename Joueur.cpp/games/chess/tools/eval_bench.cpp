@@ -0,0 +1,210 @@
+// Throughput of the hand-written evaluation over a file of positions, one at a time and in EvalBatch blocks.
+//
+//     eval-bench <positions> [passes]
+//
+// <positions> takes the tuner's format; results are optional. Three workloads are timed:
+//     engine   fullEvaluation on each state, as the search calls it (pawn table and attack maps included)
+//     traced   the traced sum of each position's coefficients, one position at a time
+//     batch    EvalBatch::evaluate over the same coefficients, in structure-of-arrays blocks
+// The last two are what re-scoring a fixed set of positions under new weights costs, which is the tuning and
+// bulk analysis workload. Batch scores are checked against the engine's.
+//
+// The engine's evaluation is then timed piece by piece, each component over every position in turn, next to the
+// mean size (in centipawns) of the terms it computes. A component that costs much and moves the score little is
+// the first candidate to simplify or drop. The pawn and material tables stay warm across passes as they would in
+// a search, so their hit rates are printed too.
+
+#include "positions.hpp"
+
+#define DEFAULT_PASSES 20
+#define BENCH_BATCH_SIZE 4096
+
+static double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Part of the evaluation computed in one go, and the EVAL_TERMS it produces
+struct Component
+{
+    const char* name;
+    std::vector<std::string> terms;
+    std::function<int(unsigned int)> evaluate;
+};
+
+static void report(const char* name, const size_t& evaluations, const double& seconds)
+{
+    std::cout << name << ": " << evaluations << " evaluations in " << seconds << "s, "
+              << (long)(evaluations / std::max(seconds, 1e-9)) << " per second" << std::endl;
+
+    return;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <positions> [passes]" << std::endl;
+        return 1;
+    }
+
+    int passes = (argc > 2) ? std::max(1, atoi(argv[2])) : DEFAULT_PASSES;
+
+    std::vector<std::string> lines;
+    if (!readLines(argv[1], lines))
+    {
+        std::cout << "Could not open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<PawnTable> pawnTable(new PawnTable());
+    std::unique_ptr<MaterialTable> materialTable(new MaterialTable());
+    std::vector<State> states;
+    std::vector<EvalTrace> traces;
+    std::vector<int> evals;
+    std::vector<std::unique_ptr<EvalBatch>> batches;
+
+    for (unsigned int i = 0; i < lines.size(); i++)
+    {
+        std::string fen;
+        State state;
+        EvalTrace trace;
+
+        parseResult(lines[i], fen);
+        if (!readPosition(fen, state))
+            continue;
+
+        evals.push_back(fullEvaluation(state, *pawnTable, *materialTable, &trace));
+
+        if (batches.empty() || batches.back()->full())
+            batches.push_back(std::unique_ptr<EvalBatch>(new EvalBatch(BENCH_BATCH_SIZE)));
+        batches.back()->add(state, trace);
+
+        states.push_back(state);
+        traces.push_back(trace);
+    }
+
+    std::cout << "Loaded " << states.size() << " positions, " << passes << " passes, " << batchKernels() << " batch kernels" << std::endl;
+    if (states.empty())
+        return 1;
+
+    std::vector<double> params(evalParams.values(), evalParams.values() + EVAL_PARAM_COUNT);
+    std::vector<float> floatParams(params.begin(), params.end());
+    std::vector<float> scores(BENCH_BATCH_SIZE);
+    double checksum = 0.0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (unsigned int i = 0; i < states.size(); i++)
+            checksum += fullEvaluation(states[i], *pawnTable, *materialTable, NULL);
+    }
+    double engineSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (unsigned int i = 0; i < traces.size(); i++)
+            checksum += tracedEvaluation(traces[i], params.data());
+    }
+    double tracedSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (unsigned int b = 0; b < batches.size(); b++)
+        {
+            batches[b]->evaluate(floatParams.data(), scores.data());
+            checksum += scores[0];
+        }
+    }
+    double batchSeconds = secondsSince(start);
+
+    // The batch must reproduce the engine up to the rounding of its two phase blends
+    int mismatches = 0, index = 0;
+    for (unsigned int b = 0; b < batches.size(); b++)
+    {
+        batches[b]->evaluate(floatParams.data(), scores.data());
+        for (int i = 0; i < batches[b]->getSize(); i++, index++)
+        {
+            if (fabs(scores[i] - evals[index]) > 2.5)
+                mismatches++;
+        }
+    }
+
+    size_t evaluations = states.size() * (size_t)passes;
+    report("engine", evaluations, engineSeconds);
+    report("traced", evaluations, tracedSeconds);
+    report("batch ", evaluations, batchSeconds);
+    std::cout << "Batch speedup over traced: " << tracedSeconds / std::max(batchSeconds, 1e-9) << "x, mismatches: " << mismatches
+              << " (checksum " << (long)checksum << ")" << std::endl;
+
+    // Mean absolute blended contribution of every term
+    std::vector<double> impact(EVAL_TERM_COUNT, 0.0);
+    for (unsigned int i = 0; i < traces.size(); i++)
+    {
+        for (int t = 0; t < EVAL_TERM_COUNT; t++)
+        {
+            double sum = 0.0;
+            for (int p = EVAL_TERMS[t].offset; p < EVAL_TERMS[t].offset + EVAL_TERMS[t].count; p++)
+                sum += traces[i].counts[p] * params[p];
+
+            if (EVAL_TERMS[t].taper == TAPER_MG)
+                sum = sum * traces[i].phase / MAX_PHASE;
+            else if (EVAL_TERMS[t].taper == TAPER_EG)
+                sum = sum * (MAX_PHASE - traces[i].phase) / MAX_PHASE;
+
+            impact[t] += fabs(sum) / traces.size();
+        }
+    }
+
+    std::vector<AttackMaps> maps;
+    for (unsigned int i = 0; i < states.size(); i++)
+        maps.push_back(AttackMaps(states[i]));
+
+    std::vector<Component> components =
+    {
+        {"psqt", {"pieceMg", "pieceEg", "psqtMg", "psqtEg"}, [&](unsigned int i) {return states[i].stateHeuristic('w');}},
+        {"imbalance", {"bishopPair", "minorsForRook", "rooksForQueen"}, [&](unsigned int i) {return materialTable->imbalance(states[i], NULL);}},
+        {"pawns", {"passedPawn", "isolatedPawn", "doubledPawn", "backwardPawn", "shieldNear", "shieldFar"},
+            [&](unsigned int i) {return pawnTable->evaluate(states[i], NULL);}},
+        {"attack maps", {}, [&](unsigned int i) {return (int)AttackMaps(states[i]).all[0];}},
+        {"attack terms", {"mobilityMg", "mobilityEg", "kingAttack", "hangingPiece"}, [&](unsigned int i) {return attackTerms(states[i], maps[i], NULL);}}
+    };
+
+    pawnTable->probes = pawnTable->hits = 0;
+    materialTable->probes = materialTable->hits = 0;
+
+    std::cout << std::endl << std::left << std::setw(14) << "component" << std::right << std::setw(10) << "ns/eval" << std::setw(8) << "share"
+              << "   terms (mean |cp|)" << std::endl;
+
+    for (unsigned int c = 0; c < components.size(); c++)
+    {
+        start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; pass++)
+        {
+            for (unsigned int i = 0; i < states.size(); i++)
+                checksum += components[c].evaluate(i);
+        }
+        double seconds = secondsSince(start);
+
+        std::cout << std::left << std::setw(14) << components[c].name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << seconds * 1e9 / evaluations << std::setw(7) << 100.0 * seconds / std::max(engineSeconds, 1e-9) << "%  ";
+        for (unsigned int n = 0; n < components[c].terms.size(); n++)
+        {
+            for (int t = 0; t < EVAL_TERM_COUNT; t++)
+            {
+                if (components[c].terms[n] == EVAL_TERMS[t].name)
+                    std::cout << " " << EVAL_TERMS[t].name << " " << impact[t];
+            }
+        }
+        if (components[c].terms.empty())
+            std::cout << " (shared by the attack terms)";
+        std::cout << std::endl;
+    }
+
+    std::cout << "Pawn table " << pawnTable->hits << " hits in " << pawnTable->probes << " probes, material table "
+              << materialTable->hits << " hits in " << materialTable->probes << " probes (checksum " << (long)checksum << ")" << std::endl;
+
+    return (mismatches == 0) ? 0 : 1;
+}
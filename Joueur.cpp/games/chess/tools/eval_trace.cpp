@@ -0,0 +1,129 @@
+// Breakdown of the hand-written evaluation of one position, term by term.
+//
+//     eval-trace [--weights <file>] <fen>
+//
+// The FEN may be passed as one argument or as several. For every term of EvalParams the tool prints the
+// middlegame and endgame contribution of each side (in centipawns, from white's point of view) and the blend of
+// the two by game phase; terms without a taper count the same in both. The blended column adds up to the
+// evaluation, which is printed beside the engine's own fullEvaluation as a check. Weights files are the tuner's.
+
+#include "positions.hpp"
+
+// Middlegame and endgame sums of one side's share of a term
+static void termSums(const EvalTerm& term, const std::vector<int>& counts, int& mg, int& eg)
+{
+    mg = 0;
+    eg = 0;
+
+    for (int i = term.offset; i < term.offset + term.count; i++)
+    {
+        int value = counts[i] * evalParams.values()[i];
+
+        if (term.taper != TAPER_EG)
+            mg += value;
+        if (term.taper != TAPER_MG)
+            eg += value;
+    }
+
+    return;
+}
+
+static double blend(const EvalTerm& term, const int& mg, const int& eg, const int& phase)
+{
+    if (term.taper == TAPER_NONE)
+        return mg;
+
+    return (double)(mg * phase + eg * (MAX_PHASE - phase)) / MAX_PHASE;
+}
+
+int main(int argc, char** argv)
+{
+    std::string fen;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--weights" && i + 1 < argc)
+        {
+            if (!evalParams.load(argv[++i]))
+            {
+                std::cout << "Could not load weights from " << argv[i] << std::endl;
+                return 1;
+            }
+            continue;
+        }
+
+        fen += (fen.empty() ? "" : " ") + std::string(argv[i]);
+    }
+
+    State state;
+    if (fen.empty() || !readPosition(fen, state))
+    {
+        std::cout << "Usage: " << argv[0] << " [--weights <file>] <fen>" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<PawnTable> pawnTable(new PawnTable());
+    std::unique_ptr<MaterialTable> materialTable(new MaterialTable());
+    EvalTrace trace(true);
+
+    int eval = fullEvaluation(state, *pawnTable, *materialTable, &trace);
+
+    std::vector<int> whiteCounts(EVAL_PARAM_COUNT);
+    for (int i = 0; i < EVAL_PARAM_COUNT; i++)
+        whiteCounts[i] = trace.counts[i] - trace.blackCounts[i];
+
+    std::cout << fen << std::endl;
+    std::cout << "Phase " << trace.phase << "/" << MAX_PHASE << " (eg terms weigh " << (MAX_PHASE - trace.phase) << "/" << MAX_PHASE << ")" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(16) << "term" << std::right
+              << std::setw(10) << "white mg" << std::setw(10) << "white eg"
+              << std::setw(10) << "black mg" << std::setw(10) << "black eg"
+              << std::setw(10) << "total" << std::endl;
+
+    double total = 0.0;
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (int t = 0; t < EVAL_TERM_COUNT; t++)
+    {
+        const EvalTerm& term = EVAL_TERMS[t];
+        int whiteMg, whiteEg, blackMg, blackEg;
+
+        termSums(term, whiteCounts, whiteMg, whiteEg);
+        termSums(term, trace.blackCounts, blackMg, blackEg);
+
+        double blended = blend(term, whiteMg, whiteEg, trace.phase) + blend(term, blackMg, blackEg, trace.phase);
+        total += blended;
+
+        std::cout << std::left << std::setw(16) << term.name << std::right;
+        if (term.taper == TAPER_EG)
+            std::cout << std::setw(10) << "-";
+        else
+            std::cout << std::setw(10) << whiteMg;
+        if (term.taper == TAPER_MG)
+            std::cout << std::setw(10) << "-";
+        else
+            std::cout << std::setw(10) << whiteEg;
+        if (term.taper == TAPER_EG)
+            std::cout << std::setw(10) << "-";
+        else
+            std::cout << std::setw(10) << blackMg;
+        if (term.taper == TAPER_MG)
+            std::cout << std::setw(10) << "-";
+        else
+            std::cout << std::setw(10) << blackEg;
+        std::cout << std::setw(10) << blended << std::endl;
+    }
+
+    std::cout << std::endl << "Sum of terms " << total << ", fullEvaluation " << eval << " (white's point of view)" << std::endl;
+
+    // The search applies endgame knowledge on top of the terms above
+    const EndgameEntry* endgame = materialTable->probe(state).endgame;
+    if (endgame && endgame->evaluate)
+        std::cout << "Known endgame: the search uses its specialised evaluation, " << endgame->evaluate(state, endgame->strongSide) << std::endl;
+    else if (endgame && endgame->insufficient)
+        std::cout << "Insufficient material: the search scores a draw" << std::endl;
+    else if (endgame)
+        std::cout << "Drawish endgame: the search scales the evaluation by " << endgame->scale << "/" << SCALE_NORMAL << std::endl;
+
+    return 0;
+}
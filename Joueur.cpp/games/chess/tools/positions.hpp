@@ -0,0 +1,78 @@
+#ifndef TOOLS_POSITIONS_HPP
+#define TOOLS_POSITIONS_HPP
+
+// Setup shared by the offline tools, and reading their position files. Include it first in each tool.
+// Each line of a position file is a FEN (or an EPD with only its first four fields), optionally followed by the
+// game result as "1-0" / "1/2-1/2" / "0-1" or "[1.0]" / "[0.5]" / "[0.0]".
+
+// The standard headers go first: ai.hpp defines FILE, which <fstream> relies on
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+
+#include "../ai.hpp"
+
+using namespace cpp_client::chess;
+
+// Result of the game a line came from (from white's point of view), -1 if the line has none. fen gets the rest.
+inline double parseResult(const std::string& line, std::string& fen)
+{
+    const char* results[] = {"1-0", "0-1", "1/2-1/2", "[1.0]", "[0.0]", "[0.5]", "[1]", "[0]"};
+    const double values[] = {1.0, 0.0, 0.5, 1.0, 0.0, 0.5, 1.0, 0.0};
+
+    for (int i = 0; i < 8; i++)
+    {
+        size_t found = line.rfind(results[i]);
+        if (found != std::string::npos && found > 0)
+        {
+            fen = line.substr(0, found);
+            fen.erase(std::remove(fen.begin(), fen.end(), '"'), fen.end());
+            return values[i];
+        }
+    }
+
+    fen = line;
+
+    return -1.0;
+}
+
+// Set up a fresh state from a FEN, with the side to move as "my" side. EPD lines carry no move counters
+// (and may carry opcodes), so a full FEN is rebuilt for State::loadFen.
+inline bool readPosition(const std::string& fen, State& state)
+{
+    std::istringstream fields(fen);
+    std::string board, side, castling, enPassant, halfMove, fullMove;
+
+    if (!(fields >> board >> side >> castling >> enPassant))
+        return false;
+    if (!(fields >> halfMove >> fullMove) || !isdigit(halfMove.at(0)) || !isdigit(fullMove.at(0)))
+    {
+        halfMove = "0";
+        fullMove = "1";
+    }
+
+    state.loadFen(board + " " + side + " " + castling + " " + enPassant + " " + halfMove + " " + fullMove, (side == "b") ? "Black" : "White");
+
+    return true;
+}
+
+// Every non-empty line of a file
+inline bool readLines(const char* path, std::vector<std::string>& lines)
+{
+    std::ifstream in(path);
+    std::string line;
+
+    if (!in)
+        return false;
+
+    while (std::getline(in, line))
+    {
+        if (!line.empty())
+            lines.push_back(line);
+    }
+
+    return true;
+}
+
+#endif
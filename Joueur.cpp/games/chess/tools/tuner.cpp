@@ -0,0 +1,284 @@
+// Offline Texel tuner for the hand-written evaluation weights (EvalParams).
+//
+//     texel-tuner [--weights <file>] <positions> <output> [iterations] [threads]
+//
+// Every line of <positions> is a quiet position as a FEN followed by the result of the game it came from, either
+// as "1-0" / "1/2-1/2" / "0-1" or as "[1.0]" / "[0.5]" / "[0.0]" (from white's point of view). The tuner fits the
+// logistic scaling K to the default weights, then runs Adam on the mean squared error between the results and
+// sigmoid(K * eval), spreading every pass over all positions across the threads. Positions are held in
+// EvalBatch blocks, so each pass runs on the vectorised batch kernels. The output is a weights file the
+// engine loads with eval_file=<output>. Tuning starts from the default weights, or from a weights file given
+// with --weights. Parameters no position exercises (the king's value, pawns on the back ranks) keep their
+// starting values.
+
+#include "positions.hpp"
+
+// Adam step size (in centipawns) and decay rates
+#define LEARNING_RATE 1.0
+#define ADAM_BETA1 0.9
+#define ADAM_BETA2 0.999
+#define ADAM_EPSILON 1e-8
+
+#define DEFAULT_ITERATIONS 2000
+#define REPORT_INTERVAL 50
+
+// Positions per batch: large enough to keep the kernels streaming, small enough to share out between threads
+#define TUNER_BATCH_SIZE 4096
+
+// A block of positions with the results of their games
+struct TunerBatch
+{
+    EvalBatch batch;
+    std::vector<float> results;
+
+    TunerBatch() : batch(TUNER_BATCH_SIZE) {}
+};
+
+static float sigmoid(const double& k, const float& eval)
+{
+    return 1.0f / (1.0f + powf(10.0f, (float)(-k * eval / 400.0)));
+}
+
+// Run a job over every index range of the data, one range per thread
+static void parallelFor(const size_t& size, const int& threads, const std::function<void(int, size_t, size_t)>& job)
+{
+    std::vector<std::thread> workers;
+    size_t chunk = (size + threads - 1) / threads;
+
+    for (int t = 0; t < threads; t++)
+        workers.push_back(std::thread(job, t, std::min(size, t * chunk), std::min(size, (t + 1) * chunk)));
+    for (unsigned int t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    return;
+}
+
+static double totalError(const std::vector<std::unique_ptr<TunerBatch>>& batches, const size_t& positions,
+                         const std::vector<float>& params, const double& k, const int& threads)
+{
+    std::vector<double> errors(threads, 0.0);
+
+    parallelFor(batches.size(), threads, [&](int t, size_t begin, size_t end)
+    {
+        std::vector<float> scores(TUNER_BATCH_SIZE);
+
+        for (size_t b = begin; b < end; b++)
+        {
+            const TunerBatch& tuner = *batches[b];
+            tuner.batch.evaluate(params.data(), scores.data());
+
+            for (int i = 0; i < tuner.batch.getSize(); i++)
+            {
+                double difference = tuner.results[i] - sigmoid(k, scores[i]);
+                errors[t] += difference * difference;
+            }
+        }
+    });
+
+    double error = 0.0;
+    for (int t = 0; t < threads; t++)
+        error += errors[t];
+
+    return error / positions;
+}
+
+// Scan for the K that best fits the starting weights, narrowing the step around the best value each round
+static double fitK(const std::vector<std::unique_ptr<TunerBatch>>& batches, const size_t& positions, const std::vector<float>& params, const int& threads)
+{
+    double best = 1.0, step = 0.25;
+    double bestError = totalError(batches, positions, params, best, threads);
+
+    for (int round = 0; round < 6; round++)
+    {
+        double centre = best;
+        for (double k = std::max(0.05, centre - 4 * step); k <= centre + 4 * step; k += step)
+        {
+            double error = totalError(batches, positions, params, k, threads);
+            if (error < bestError)
+            {
+                bestError = error;
+                best = k;
+            }
+        }
+        step /= 4;
+    }
+
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--weights" && i + 1 < argc)
+        {
+            // Before any position is read: states pick up the weights as their pieces are placed
+            if (!evalParams.load(argv[++i]))
+            {
+                std::cout << "Could not load weights from " << argv[i] << std::endl;
+                return 1;
+            }
+            continue;
+        }
+
+        args.push_back(argv[i]);
+    }
+
+    if (args.size() < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " [--weights <file>] <positions> <output> [iterations] [threads]" << std::endl;
+        return 1;
+    }
+
+    int iterations = (args.size() > 2) ? atoi(args[2].c_str()) : DEFAULT_ITERATIONS;
+    int threads = (args.size() > 3) ? atoi(args[3].c_str()) : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, threads);
+
+    std::vector<std::string> lines;
+    if (!readLines(args[0].c_str(), lines))
+    {
+        std::cout << "Could not open " << args[0] << std::endl;
+        return 1;
+    }
+
+    std::vector<double> params(evalParams.values(), evalParams.values() + EVAL_PARAM_COUNT);
+    std::vector<float> floatParams(params.begin(), params.end());
+
+    // Trace every position through the engine's own evaluation, and check the trace adds back up to it
+    std::vector<std::vector<std::unique_ptr<TunerBatch>>> loaded(threads);
+    std::vector<std::vector<char>> used(threads, std::vector<char>(EVAL_PARAM_COUNT, 0));
+    std::atomic<int> mismatches(0);
+
+    parallelFor(lines.size(), threads, [&](int t, size_t begin, size_t end)
+    {
+        std::unique_ptr<PawnTable> pawnTable(new PawnTable());
+        std::unique_ptr<MaterialTable> materialTable(new MaterialTable());
+
+        for (size_t i = begin; i < end; i++)
+        {
+            std::string fen;
+            State state;
+            EvalTrace trace;
+
+            double result = parseResult(lines[i], fen);
+            if (result < 0.0 || !readPosition(fen, state))
+                continue;
+
+            int eval = fullEvaluation(state, *pawnTable, *materialTable, &trace);
+
+            // The engine rounds each of its two phase blends down, so allow a point for each
+            if (fabs(tracedEvaluation(trace, params.data()) - eval) > 2.0)
+            {
+                mismatches++;
+                continue;
+            }
+
+            if (loaded[t].empty() || loaded[t].back()->batch.full())
+                loaded[t].push_back(std::unique_ptr<TunerBatch>(new TunerBatch()));
+
+            loaded[t].back()->batch.add(state, trace);
+            loaded[t].back()->results.push_back((float)result);
+
+            for (int p = 0; p < EVAL_PARAM_COUNT; p++)
+                used[t][p] |= (trace.counts[p] != 0);
+        }
+    });
+
+    std::vector<std::unique_ptr<TunerBatch>> batches;
+    size_t positions = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        for (unsigned int b = 0; b < loaded[t].size(); b++)
+        {
+            positions += loaded[t][b]->batch.getSize();
+            batches.push_back(std::move(loaded[t][b]));
+        }
+    }
+    std::vector<std::string>().swap(lines);
+
+    // A parameter whose coefficient is zero in every position gets no gradient, only float noise
+    std::vector<char> tuned(EVAL_PARAM_COUNT, 0);
+    int tunedCount = 0;
+    for (int p = 0; p < EVAL_PARAM_COUNT; p++)
+    {
+        for (int t = 0; t < threads; t++)
+            tuned[p] |= used[t][p];
+        tunedCount += tuned[p];
+    }
+
+    std::cout << "Loaded " << positions << " positions in " << batches.size() << " batches (" << batchKernels() << " kernels)";
+    if (mismatches > 0)
+        std::cout << ", skipped " << mismatches << " whose trace did not match the evaluation";
+    std::cout << std::endl << "Tuning " << tunedCount << " of " << EVAL_PARAM_COUNT << " parameters" << std::endl;
+
+    if (positions == 0)
+        return 1;
+
+    double k = fitK(batches, positions, floatParams, threads);
+    std::cout << "K = " << k << ", starting error " << totalError(batches, positions, floatParams, k, threads) << std::endl;
+
+    std::vector<double> moment(EVAL_PARAM_COUNT, 0.0), velocity(EVAL_PARAM_COUNT, 0.0);
+    std::vector<std::vector<float>> gradients(threads, std::vector<float>(EVAL_PARAM_COUNT, 0.0f));
+
+    for (int iteration = 1; iteration <= iterations; iteration++)
+    {
+        // d(error)/d(param), split over the threads and summed afterwards
+        parallelFor(batches.size(), threads, [&](int t, size_t begin, size_t end)
+        {
+            std::vector<float> scores(TUNER_BATCH_SIZE), factors(TUNER_BATCH_SIZE);
+            std::fill(gradients[t].begin(), gradients[t].end(), 0.0f);
+
+            for (size_t b = begin; b < end; b++)
+            {
+                const TunerBatch& tuner = *batches[b];
+                tuner.batch.evaluate(floatParams.data(), scores.data());
+
+                for (int i = 0; i < tuner.batch.getSize(); i++)
+                {
+                    float s = sigmoid(k, scores[i]);
+                    factors[i] = (tuner.results[i] - s) * s * (1.0f - s);
+                }
+
+                tuner.batch.gradient(factors.data(), gradients[t].data());
+            }
+        });
+
+        for (int p = 0; p < EVAL_PARAM_COUNT; p++)
+        {
+            if (!tuned[p])
+                continue;
+
+            double gradient = 0.0;
+            for (int t = 0; t < threads; t++)
+                gradient += gradients[t][p];
+
+            // The constant factors of the derivative are left to the learning rate, only the sign matters here
+            gradient = -gradient / positions;
+
+            moment[p] = ADAM_BETA1 * moment[p] + (1.0 - ADAM_BETA1) * gradient;
+            velocity[p] = ADAM_BETA2 * velocity[p] + (1.0 - ADAM_BETA2) * gradient * gradient;
+
+            double correctedMoment = moment[p] / (1.0 - pow(ADAM_BETA1, iteration));
+            double correctedVelocity = velocity[p] / (1.0 - pow(ADAM_BETA2, iteration));
+            params[p] -= LEARNING_RATE * correctedMoment / (sqrt(correctedVelocity) + ADAM_EPSILON);
+            floatParams[p] = (float)params[p];
+        }
+
+        if (iteration % REPORT_INTERVAL == 0 || iteration == iterations)
+            std::cout << "Iteration " << iteration << ", error " << totalError(batches, positions, floatParams, k, threads) << std::endl;
+    }
+
+    EvalParams result;
+    for (int p = 0; p < EVAL_PARAM_COUNT; p++)
+        result.values()[p] = (int)lround(params[p]);
+
+    if (!result.save(args[1]))
+    {
+        std::cout << "Could not write " << args[1] << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << args[1] << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+// Layout of the data word: score (32 bits) | move (16) | depth (8) | bound (2) | generation (6)
+static uint64_t packData(const int& score, const uint16_t& move, const int& depth, const int& bound, const uint8_t& generation)
+{
+    return (uint64_t)(uint32_t)score
+         | ((uint64_t)move << 32)
+         | ((uint64_t)(uint8_t)std::max(0, std::min(depth, 255)) << 48)
+         | ((uint64_t)bound << 56)
+         | ((uint64_t)generation << 58);
+}
+
+static int dataScore(const uint64_t& data) {return (int)(uint32_t)data;}
+static uint16_t dataMove(const uint64_t& data) {return (uint16_t)(data >> 32);}
+static int dataDepth(const uint64_t& data) {return (int)((data >> 48) & 0xFF);}
+static int dataBound(const uint64_t& data) {return (int)((data >> 56) & 0x3);}
+static uint8_t dataGeneration(const uint64_t& data) {return (uint8_t)(data >> 58);}
+
+TranspositionTable::TranspositionTable()
+{
+    size = 0;
+    generation = 0;
+}
+
+void TranspositionTable::resize(const int& megabytes)
+{
+    uint64_t entries = ((uint64_t)std::max(1, megabytes) << 20) / sizeof(TTEntry);
+
+    size = 1;
+    while (size * 2 <= entries)
+        size *= 2;
+
+    table.reset(new TTEntry[size]);
+    clear();
+
+    return;
+}
+
+void TranspositionTable::clear()
+{
+    for (uint64_t i = 0; i < size; i++)
+    {
+        table[i].keyXorData.store(0, std::memory_order_relaxed);
+        table[i].data.store(0, std::memory_order_relaxed);
+    }
+
+    return;
+}
+
+bool TranspositionTable::probe(const uint64_t& key, TTData& entry) const
+{
+    if (size == 0)
+        return false;
+
+    const TTEntry& e = table[key & (size - 1)];
+    uint64_t data = e.data.load(std::memory_order_relaxed);
+
+    if (data == 0 || (e.keyXorData.load(std::memory_order_relaxed) ^ data) != key)
+        return false;
+
+    entry.score = dataScore(data);
+    entry.move = dataMove(data);
+    entry.depth = dataDepth(data);
+    entry.bound = dataBound(data);
+
+    return true;
+}
+
+void TranspositionTable::store(const uint64_t& key, const int& score, const int& depth, const int& bound, const uint16_t& move)
+{
+    if (size == 0)
+        return;
+
+    TTEntry& e = table[key & (size - 1)];
+    uint64_t oldData = e.data.load(std::memory_order_relaxed);
+    bool sameKey = (e.keyXorData.load(std::memory_order_relaxed) ^ oldData) == key;
+    uint16_t bestMove = move;
+
+    if (oldData != 0)
+    {
+        // Keep deeper results from this search unless the new one is exact
+        if (dataGeneration(oldData) == generation && depth < dataDepth(oldData) - (sameKey ? 0 : 2) && bound != TT_EXACT)
+            return;
+
+        // Don't lose a known best move to a result that has none
+        if (sameKey && bestMove == 0)
+            bestMove = dataMove(oldData);
+    }
+
+    uint64_t data = packData(score, bestMove, depth, bound, generation);
+    e.keyXorData.store(key ^ data, std::memory_order_relaxed);
+    e.data.store(data, std::memory_order_relaxed);
+
+    return;
+}
+
+int TranspositionTable::hashfull() const
+{
+    uint64_t sample = std::min(size, (uint64_t)1000);
+    int used = 0;
+
+    for (uint64_t i = 0; i < sample; i++)
+    {
+        uint64_t data = table[i].data.load(std::memory_order_relaxed);
+        if (data != 0 && dataGeneration(data) == generation)
+            used++;
+    }
+
+    return (sample == 0) ? 0 : (int)(used * 1000 / sample);
+}
+
+}
+}
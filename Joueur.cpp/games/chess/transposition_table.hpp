@@ -0,0 +1,53 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+// Bound types of a stored score
+#define TT_EXACT 0
+#define TT_LOWER 1
+#define TT_UPPER 2
+
+// Default size of the table (in MB), overridable with hash=<MB>
+#define DEFAULT_HASH_SIZE 64
+
+// Unpacked contents of a table entry
+struct TTData
+{
+    int score;
+    int depth;
+    int bound;
+    uint16_t move;
+};
+
+// The key is stored XORed with the data so an entry torn by two threads writing at once fails the key check on probe.
+struct TTEntry
+{
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+};
+
+// Lock-free transposition table shared by all search threads
+class TranspositionTable
+{
+    private:
+        std::unique_ptr<TTEntry[]> table;
+        uint64_t size;
+        uint8_t generation;
+
+    public:
+        TranspositionTable();
+
+        // Reallocate the table to the largest power of two number of entries that fits in the given size
+        void resize(const int& megabytes);
+        void clear();
+
+        // Age the table at the start of each search so stale entries are replaced first
+        void newSearch() {generation = (generation + 1) & 63; return;}
+
+        bool probe(const uint64_t& key, TTData& entry) const;
+        void store(const uint64_t& key, const int& score, const int& depth, const int& bound, const uint16_t& move);
+
+        // Permille of a sample of entries written during the current search
+        int hashfull() const;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "ai.hpp"
+
+namespace cpp_client
+{
+namespace chess
+{
+
+const ZobristKeys zobrist;
+
+ZobristKeys::ZobristKeys()
+{
+    std::mt19937_64 rng(0x9E3779B97F4A7C15ULL);
+
+    for (int i = 0; i < 12; i++)
+        for (int j = 0; j < RANK * FILE; j++)
+            pieces[i][j] = rng();
+
+    for (int i = 0; i < 16; i++)
+        castling[i] = rng();
+
+    for (int i = 0; i < FILE; i++)
+        enPassant[i] = rng();
+
+    side = rng();
+}
+
+int pieceIndex(const char& letter)
+{
+    switch(letter)
+    {
+        case 'P': return 0;
+        case 'N': return 1;
+        case 'B': return 2;
+        case 'R': return 3;
+        case 'Q': return 4;
+        case 'K': return 5;
+        case 'p': return 6;
+        case 'n': return 7;
+        case 'b': return 8;
+        case 'r': return 9;
+        case 'q': return 10;
+        case 'k': return 11;
+        default: return -1;
+    }
+}
+
+}
+}
@@ -0,0 +1,23 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+// Random keys used to hash positions. Filled once from a fixed seed so keys are identical between runs.
+struct ZobristKeys
+{
+    uint64_t pieces[12][RANK * FILE];
+    uint64_t castling[16];
+    uint64_t enPassant[FILE];
+    uint64_t side;
+
+    ZobristKeys();
+};
+
+extern const ZobristKeys zobrist;
+
+// Index of a piece letter into the piece tables (P N B R Q K p n b r q k), -1 for an empty square
+int pieceIndex(const char& letter);
+
+// Index of a square (rank 1-8, file index 0-7) into the square tables
+inline int squareIndex(const int& rank, const int& file) {return (rank - 1) * FILE + file;}
+
+#endif